@@ -0,0 +1,131 @@
+#!/bin/bash
+# Regression benchmark: runs a fixed set of cases (mode, size, test, threads) and compares
+# the median of the times of each one with the median in benchmark_baseline.csv.
+# A case is a regression if it is slower than the baseline by more than its tolerance, that
+# is the largest between THRESHOLD, 3 times the noise (MAD/median) and the spread between the
+# medians of the rounds (slowest/fastest-1) of the baseline or of this run, so noisy cases
+# need a bigger difference, but never more than MAXTOLERANCE, so a
+# noisy case still catches a big slowdown. All the cases are run ROUNDS times one after the
+# other and each one keeps the round with the lowest median, so a disturbance of the machine
+# during some rounds isn't taken as a regression. The threads are pinned with
+# TRANSPOSE_PLACES (compact if not given), so they don't move between the CPUs during the
+# measure, and the destination is allocated before the measure (TRANSPOSE_DESTINATION=eager). With at least one regression it exits with 1, after the table with all the cases.
+# Usage:
+#   ./benchmark.sh             compares with the baseline
+#   ./benchmark.sh --update    writes the baseline with the results of this machine
+# Environment: SAMPLES (default 25), ROUNDS (default 5), THRESHOLD (default 0.10, 10%),
+#              MAXTOLERANCE (default 0.25, 25%), TRANSPOSE_PLACES (default compact)
+cd "$(dirname "$0")" || exit 1
+baseline="benchmark_baseline.csv"
+samples=${SAMPLES:-25}
+rounds=${ROUNDS:-5}
+threshold=${THRESHOLD:-0.10}
+maxtolerance=${MAXTOLERANCE:-0.25}
+export TRANSPOSE_PLACES=${TRANSPOSE_PLACES:-compact}
+export TRANSPOSE_DESTINATION=eager
+# Cases: mode, exponent of the size, test mode, threads
+cases=(
+    "1 10 0 1"
+    "2 10 0 1"
+    "3 10 0 1"
+    "7 10 0 1"
+    "7 10 2 1"
+    "7 12 0 1"
+    "7 10 0 4"
+    "9 10 0 4"
+    "10 12 0 1"
+    "11 10 0 2"
+    "12 12 0 1"
+)
+# Functions
+function median {
+    sort -g | awk '{v[NR]=$1} END {if(NR==0) print 0; else if(NR%2) print v[(NR+1)/2]; else print (v[NR/2]+v[NR/2+1])/2}'
+}
+function execution {
+    local mode=$1 size=$2 test=$3 threads=$4 dir=$5
+    mkdir -p "$dir"
+    (
+        cd "$dir" || exit 1
+        if [ "$mode" -le 3 ]; then
+            "$binary" BENCH "$mode" "$size" "$test" "$samples"
+        else
+            OMP_NUM_THREADS=$threads "$binary" BENCH "$mode" "$size" "$test" "$samples" "$threads"
+        fi
+    ) > "$dir/output.txt" 2>&1
+}
+
+work=$(mktemp -d)
+binary="$work/transpose"
+trap 'rm -rf "$work"' EXIT
+gcc -O2 -march=native functions.c main.c -o "$binary" -fopenmp -lm -pthread || exit 1
+rounds_file="$work/rounds.csv"
+for ((round=1; round<=rounds; round++)); do
+    for c in "${cases[@]}"; do
+        read -r mode size test threads <<< "$c"
+        dir="$work/round_${round}/case_${mode}_${size}_${test}_${threads}"
+        if ! execution "$mode" "$size" "$test" "$threads" "$dir"; then
+            echo "Case mode=$mode size=$size test=$test threads=$threads failed:"
+            cat "$dir/output.txt"
+            exit 1
+        fi
+        awk 'NR>1 {print $8}' "$dir/timesGeneral.csv" > "$dir/times.txt"
+        med=$(median < "$dir/times.txt")
+        mad=$(awk -v m="$med" '{d=$1-m; if(d<0) d=-d; print d}' "$dir/times.txt" | median)
+        printf "%-5s %-10s %-10s %-10s %-15.12f %-15.12f\n" "$mode" "$((1<<size))" "$test" "$threads" "$med" "$mad" >> "$rounds_file"
+    done
+done
+#Best round of each case, in the order of the cases, with the spread between its rounds
+run="$work/run.csv"
+awk '{key=$1" "$2" "$3" "$4
+      if(!(key in best)) {order[++count]=key; best[key]=$0; med[key]=$5; worst[key]=$5}
+      else {if($5<med[key]) {best[key]=$0; med[key]=$5}; if($5>worst[key]) worst[key]=$5}}
+     END {for (i=1; i<=count; i++) {key=order[i]; printf "%s %-10.4f\n", best[key], (med[key]>0 ? worst[key]/med[key]-1 : 0)}}' "$rounds_file" > "$run"
+
+if [ "$1" == "--update" ]; then
+    {
+        echo "# $(lscpu 2>/dev/null | grep 'Model name' | sed 's/Model name: *//'), $samples samples, best of $rounds rounds, TRANSPOSE_PLACES=$TRANSPOSE_PLACES, $(date +%Y-%m-%d)"
+        printf "%-5s %-10s %-10s %-10s %-15s %-15s %-10s\n" "Mode" "Dimension" "Test_Mode" "Threads" "Median(s)" "MAD(s)" "Spread"
+        cat "$run"
+    } > "$baseline"
+    echo "Baseline written in $baseline"
+    exit 0
+fi
+if [ ! -f "$baseline" ]; then
+    echo "Missing $baseline, create it with $0 --update"
+    exit 1
+fi
+awk -v threshold="$threshold" -v maxtolerance="$maxtolerance" '
+    function noise(med, mad) { return med>0 ? 3*mad/med : 0 }
+    NR==FNR {
+        if($1 ~ /^#/ || $1=="Mode") next
+        key=$1" "$2" "$3" "$4; base[key]=$5; basemad[key]=$6; basespread[key]=$7; next
+    }
+    BEGIN {
+        printf "%-5s %-10s %-10s %-10s %-15s %-15s %-10s %-10s %s\n", "Mode", "Dimension", "Test_Mode", "Threads", "Baseline(s)", "Now(s)", "Change", "Tolerance", "Status"
+    }
+    {
+        key=$1" "$2" "$3" "$4
+        if(!(key in base)) {
+            printf "%-5s %-10s %-10s %-10s %-15s %-15.12f %-10s %-10s %s\n", $1, $2, $3, $4, "-", $5, "-", "-", "NEW"
+            next
+        }
+        tolerance=threshold
+        if(noise(base[key], basemad[key])>tolerance) tolerance=noise(base[key], basemad[key])
+        if(noise($5, $6)>tolerance) tolerance=noise($5, $6)
+        if(basespread[key]>tolerance) tolerance=basespread[key]
+        if($7>tolerance) tolerance=$7
+        if(tolerance>maxtolerance) tolerance=maxtolerance
+        change=base[key]>0 ? $5/base[key]-1 : 0
+        status="OK"
+        if(change>tolerance) { status="REGRESSION"; regressions++ }
+        else if(change<-tolerance) status="FASTER"
+        printf "%-5s %-10s %-10s %-10s %-15.12f %-15.12f %+8.1f%%  %8.1f%%  %s\n", $1, $2, $3, $4, base[key], $5, change*100, tolerance*100, status
+    }
+    END {
+        if(regressions>0) {
+            printf "\n%d regressions\n", regressions
+            exit 1
+        }
+        printf "\nNo regressions\n"
+    }
+' "$baseline" "$run"
@@ -0,0 +1,98 @@
+//
+//  client.c
+//  Matrix Transposition
+//
+//Example client of the daemon: puts <requests> matrices n x n and their destinations in a single memfd,
+//sends all the requests (the daemon executes them in batch), waits the replies and verifies the results
+//gcc -O2 functions.c client.c -o transpose_client -fopenmp -lm -pthread
+//./transpose_client <size> <test_mode> <requests> [type: 1 transpose, 2 check, 3 check + transpose]
+#include "functions.h" //first, it defines _GNU_SOURCE (memfd_create)
+
+int main(int argc, const char * argv[]) {
+    //Input parameters
+    if(argc<4) {
+        fprintf(stderr, "Usage: %s <size> <test_mode> <requests> [type]\n", argv[0]);
+        exit(1);
+    }
+    const int N=valueInputed(argc, argv[1], 3);
+    const int TESTING=valueInputed(argc, argv[2], 4);
+    const int REQUESTS=atoi(argv[3]);
+    const RequestType TYPE=(argc>4) ? (RequestType)atoi(argv[4]) : REQ_CHECK_TRANSPOSE;
+    if(REQUESTS<1 || TYPE<REQ_TRANSPOSE || TYPE>REQ_CHECK_TRANSPOSE) {
+        fprintf(stderr, "Invalid number of requests or type\n");
+        exit(1);
+    }
+    const char* PATH=(getenv(SOCKETVARIABLE)!=NULL) ? getenv(SOCKETVARIABLE) : DAEMONSOCKET;
+    const int SOCK=daemonConnect(PATH);
+    if(SOCK<0) {
+        fprintf(stderr, "Couldn't connect to the daemon on %s\n", PATH);
+        exit(1);
+    }
+    //Shared memory: M and T of each request one after the other
+    const size_t BYTES=sizeof(float)*(size_t)N*N;
+    const int FD=memfd_create("transpose", MFD_CLOEXEC);
+    if(FD<0 || ftruncate(FD, 2*BYTES*REQUESTS)<0) {
+        perror("memfd");
+        exit(1);
+    }
+    char* data=mmap(NULL, 2*BYTES*REQUESTS, PROT_READ|PROT_WRITE, MAP_SHARED, FD, 0);
+    float** M=malloc(sizeof(float*)*N);
+    if(data==MAP_FAILED || M==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    for (int k=0; k<REQUESTS; k++) {
+        for (int i=0; i<N; i++) {
+            M[i]=(float*)(data+2*BYTES*k)+(size_t)i*N;
+        }
+        initializeMatrixRows(M, TESTING, getTestSeed(TESTING)+k, N, 0, N);
+    }
+    //Sending all the requests and waiting all the replies
+    //CLOCK_MONOTONIC and not omp_get_wtime: the client builds also without -fopenmp
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int k=0; k<REQUESTS; k++) {
+        DaemonRequest request={.id=k, .type=TYPE, .rows=N, .cols=N, .sublength=0, .offset_in=2*BYTES*k, .offset_out=2*BYTES*k+BYTES};
+        if(daemonSend(SOCK, &request, FD)<0) {
+            perror("send");
+            exit(1);
+        }
+    }
+    int errors=0, symmetric=0;
+    for (int k=0; k<REQUESTS; k++) {
+        DaemonReply reply;
+        if(recv(SOCK, &reply, sizeof(reply), MSG_WAITALL)!=(ssize_t)sizeof(reply)) {
+            fprintf(stderr, "The daemon closed the connection\n");
+            exit(1);
+        }
+        if(reply.status!=0) {
+            fprintf(stderr, "Request %llu failed: %s\n", (unsigned long long)reply.id, strerror(reply.status));
+            errors++;
+            continue;
+        }
+        symmetric+=reply.symmetric;
+        //Control of the transposed ones
+        const float* A=(const float*)(data+2*BYTES*reply.id);
+        const float* B=(const float*)(data+2*BYTES*reply.id+BYTES);
+        if(TYPE==REQ_TRANSPOSE || (TYPE==REQ_CHECK_TRANSPOSE && !reply.symmetric)) {
+            for (int i=0; i<N && errors==0; i++) {
+                for (int j=0; j<N; j++) {
+                    if(B[(size_t)i*N+j]!=A[(size_t)j*N+i]) {
+                        fprintf(stderr, "Wrong result in request %llu at [%d][%d]\n", (unsigned long long)reply.id, i, j);
+                        errors++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    const double time=(double)(end.tv_sec-start.tv_sec)+(double)(end.tv_nsec-start.tv_nsec)*1e-9;
+    printf("Requests: %d\nSymmetric: %d\nErrors: %d\nTime Elapsed (get time)=%.12f (%.12f per request)\n", REQUESTS, symmetric, errors, time, time/REQUESTS);
+    //Free Memory
+    free(M);
+    munmap(data, 2*BYTES*REQUESTS);
+    close(FD);
+    close(SOCK);
+    return errors>0;
+}
@@ -0,0 +1,110 @@
+//
+//  daemon.c
+//  Matrix Transposition
+//
+//Daemon: keeps the pool of threads (and the arrays of the rows) alive between the requests and
+//receives them on a UNIX socket, with the matrices in a memfd of the client, so nothing is copied
+//gcc -O2 functions.c daemon.c -o transpose_daemon -fopenmp -lm -pthread
+//./transpose_daemon [threads]   (TRANSPOSE_SOCKET for the path, TRANSPOSE_PLACES for the placement, TRANSPOSE_TRACE for the trace at the exit)
+#include "functions.h" //first, it defines _GNU_SOURCE (accept4)
+#include <signal.h>
+
+static volatile sig_atomic_t stop=0;
+
+static void stopDaemon(int signal) {
+    (void)signal;
+    stop=1;
+}
+
+int main(int argc, const char * argv[]) {
+    //Initialization
+    const int NUM_THREADS=(argc>1) ? atoi(argv[1]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(NUM_THREADS<1 || NUM_THREADS>MAX_THREADS) {
+        fprintf(stderr, "Invalid number of threads, it has to be between 1 and %d\n", MAX_THREADS);
+        exit(1);
+    }
+    traceInit();
+    int* cpus=getPlacement(getenv(PLACESVARIABLE), NUM_THREADS);
+    ThreadPool* pool=threadPoolCreate(NUM_THREADS, cpus);
+    free(cpus);
+    const char* PATH=(getenv(SOCKETVARIABLE)!=NULL) ? getenv(SOCKETVARIABLE) : DAEMONSOCKET;
+    const int LISTENER=daemonListen(PATH);
+    //Without SA_RESTART poll returns at the signal
+    struct sigaction action={.sa_handler=stopDaemon};
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    printf("Listening on %s with %d threads\n", PATH, NUM_THREADS);
+    fflush(stdout);
+    struct pollfd fds[DAEMONCLIENTS+1];
+    bool closed[DAEMONCLIENTS+1];
+    int clients=0;
+    fds[0]=(struct pollfd){.fd=LISTENER, .events=POLLIN};
+    DaemonJob* jobs=malloc(sizeof(DaemonJob)*DAEMONBATCH);
+    if(jobs==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    while(!stop) {
+        if(poll(fds, clients+1, -1)<0) {
+            if(errno==EINTR) {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+        if(fds[0].revents&POLLIN) {
+            int client=accept4(LISTENER, NULL, NULL, SOCK_NONBLOCK|SOCK_CLOEXEC);
+            if(client>=0 && clients<DAEMONCLIENTS) {
+                clients++;
+                fds[clients]=(struct pollfd){.fd=client, .events=POLLIN};
+            }
+            else if(client>=0) {
+                close(client);
+            }
+        }
+        //Batch: all the requests already arrived from all the clients, up to DAEMONBATCH
+        int count=0;
+        for (int c=1; c<=clients; c++) {
+            closed[c]=false;
+            if(!(fds[c].revents&(POLLIN|POLLHUP|POLLERR))) {
+                continue;
+            }
+            while(count<DAEMONBATCH) {
+                int received=daemonReceive(fds[c].fd, &jobs[count].request, &jobs[count].fd);
+                if(received<=0) {
+                    closed[c]=(received<0);
+                    break;
+                }
+                jobs[count].client=fds[c].fd;
+                count++;
+            }
+        }
+        daemonExecute(pool, jobs, count);
+        for (int k=0; k<count; k++) {
+            if(send(jobs[k].client, &jobs[k].reply, sizeof(DaemonReply), MSG_NOSIGNAL)!=(ssize_t)sizeof(DaemonReply)) {
+                fprintf(stderr, "Couldn't reply to the request %llu\n", (unsigned long long)jobs[k].reply.id);
+            }
+        }
+        //Closed clients removed after the replies, so their socket isn't reused in the middle of the batch
+        for (int c=clients; c>=1; c--) {
+            if(closed[c]) {
+                close(fds[c].fd);
+                fds[c]=fds[clients];
+                closed[c]=closed[clients];
+                clients--;
+            }
+        }
+    }
+    //Free Memory
+    for (int c=1; c<=clients; c++) {
+        close(fds[c].fd);
+    }
+    close(LISTENER);
+    unlink(PATH);
+    free(jobs);
+    traceWrite();
+    threadPoolDestroy(pool);
+    return 0;
+}
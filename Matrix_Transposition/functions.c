@@ -7,6 +7,28 @@
 
 #include "functions.h"
 
+/*
+ * Pool used by PTH_BB, created by threadInit
+ */
+static ThreadPool* defaultPool=NULL;
+
+/*
+ * Tracer: enabled by traceInit with TRANSPOSE_TRACE, a ring for each thread that records something
+ */
+bool traceEnabled=false;
+static TraceBuffer traceBuffers[TRACETHREADS];
+static atomic_int traceThreads;
+static _Thread_local int traceThread=-1;    //index of the ring of the thread, -2 if there are no more rings
+static uint64_t traceOrigin=0;
+
+/*
+ * Memory accounting of the matrices of allocateMatrixPerMode and freeMatrixPerMode (the pipeline threads allocate too)
+ */
+static atomic_long matrixAllocations;
+static atomic_long matrixFrees;
+static atomic_long matrixBytes;
+static atomic_long matrixPeakBytes;
+
 /*
  * Name: random_float2
  * Generates a random float number in a range with 2 decimals
@@ -20,6 +42,57 @@ float random_float2 (int min, int max) {
     return (rand()%(max-min+1)+min)*1.0/100;
 }
 
+/*
+ * Name: splitmix64
+ * Finalizer of the SplitMix64 generator: a bijection of 64 bits that spreads each bit of x on all the
+ * bits of the result, so consecutive counters give independent looking numbers
+ * Input: x (uint64_t) - The counter
+ * Output: uint64_t - The mixed value
+ */
+
+inline uint64_t splitmix64(uint64_t x) {
+    x+=0x9E3779B97F4A7C15ULL;
+    x=(x^(x>>30))*0xBF58476D1CE4E5B9ULL;
+    x=(x^(x>>27))*0x94D049BB133111EBULL;
+    return x^(x>>31);
+}
+
+/*
+ * Name: counter_float2
+ * Counter-based version of random_float2: the value is a function only of (seed, i, j) and not of a
+ * global state like rand(), so each thread can generate any element in any order and the matrix is
+ * the same for any number of threads (or ranks)
+ * Input:
+ *      seed (uint64_t) - Seed of the matrix (see getTestSeed)
+ *      i (long) - Row of the element
+ *      j (long) - Column of the element
+ *      min (int) - Minimum value of the range
+ *      max (int) - Maximum value of the range
+ * Output: float - Randomize value with 2 decimals
+ */
+
+inline float counter_float2(uint64_t seed, long i, long j, int min, int max) {
+    uint64_t x=splitmix64(seed^splitmix64(((uint64_t)i<<32)|(uint32_t)j));
+    //Multiply-shift instead of a 64 bit modulo (no division, so the loop of initializeRow is vectorized):
+    //the high 32 bits of x scaled on the range, as uniform as the modulo for ranges much smaller than 2^32
+    const uint32_t range=(uint32_t)(max-min+1);
+    return ((int)(((x>>32)*range)>>32)+min)*1.0/100;
+}
+
+/*
+ * Name: getTestSeed
+ * Seed of the matrices of a test: fixed for STATIC (same matrix in each run) and from the clock for RANDOM
+ * Input: test (Test) - The test type
+ * Output: uint64_t - The seed for counter_float2
+ */
+
+uint64_t getTestSeed(Test test) {
+    if(test==RANDOM) {
+        return (uint64_t)time(NULL);
+    }
+    return 38;
+}
+
 /*
  * Name: createFloatSquareMatrix
  * Create in the heap a square matrix
@@ -73,6 +146,94 @@ float** createFloatSquareMatrixAligned(int n, int sublength) {
     return temp;
 }
 
+/*
+ * Name: createFloatMatrixContiguous
+ * Create in the heap a rows x cols matrix stored in a single aligned block, so
+ * that row i starts exactly cols floats after row i-1. The array of pointers is
+ * kept to use it with the same kernels of the other matrices, but the data can
+ * be passed as a unique buffer (needed by MPI to send or receive tiles with
+ * derived datatypes). Has to be freed with freeMatrixContiguous
+ * Input:
+ *      rows (int) - Number of rows
+ *      cols (int) - Number of columns
+ *      sublength (int) - Alignment in number of pointers (as createFloatSquareMatrixAligned)
+ * Output: float** - Matrix address, temp[0] is the address of the whole block
+ */
+float** createFloatMatrixContiguous(int rows, int cols, int sublength) {
+    return createFloatMatrixPadded(rows, cols, cols, sublength);
+}
+/*
+ * Name: createFloatMatrixPadded
+ * See createFloatMatrixContiguous - The rows are ld floats apart instead of cols (leading dimension),
+ * the last ld-cols of each row are not used. With a power of two of floats in each row, the elements
+ * of a column fall all in the same sets of the caches and with the walk by columns of the transposition
+ * only few ways are used; with some more bytes the rows start in different sets. The kernels use
+ * the pointers of the rows, so they don't see the padding. Has to be freed with freeMatrixContiguous
+ * Input:
+ *      rows (int) - Number of rows
+ *      cols (int) - Number of columns
+ *      ld (int) - Distance in floats between two rows (at least cols)
+ *      sublength (int) - Alignment in number of pointers (as createFloatSquareMatrixAligned)
+ * Output: float** - Matrix address, temp[0] is the address of the whole block
+ */
+float** createFloatMatrixPadded(int rows, int cols, int ld, int sublength) {
+    if(ld<cols) {
+        fprintf(stderr, "Error, the leading dimension %d is less than the columns %d\n", ld, cols);
+        exit(1);
+    }
+    size_t alignment=sublength*sizeof(float*);
+    //aligned_alloc requires a size multiple of the alignment. The array of the rows is aligned too, as the
+    //kernels declare it with the aligned clause of omp simd
+    size_t pointers=sizeof(float*)*(size_t)rows;
+    pointers=(pointers+alignment-1)/alignment*alignment;
+    float** temp=(float**)aligned_alloc(alignment, pointers);
+    if(temp==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    size_t bytes=sizeof(float)*(size_t)rows*ld;
+    bytes=(bytes+alignment-1)/alignment*alignment;
+    float* block=(float*)aligned_alloc(alignment, bytes);
+    if(block==NULL) {
+        printf("Memory allocation failed\n");
+        free(temp);
+        exit(1);
+    }
+    for (int i=0; i<rows; i++) {
+        temp[i]=block+(size_t)i*ld;
+    }
+    return temp;
+}
+/*
+ * Name: getLeadingDimension
+ * Leading dimension of the aligned matrices from TRANSPOSE_PAD (read only once):
+ *      auto (default) - one cache line more when a row is a multiple of 4 cache lines (all the sizes of
+ *                       the program from 64), as the rows would start in the same sets
+ *      a number of cache lines - always that padding, 0 for rows without padding
+ * Input: cols (int) - Number of columns
+ * Output: int - The leading dimension in floats
+ */
+int getLeadingDimension(int cols) {
+    static int lines=-2;
+    if(lines==-2) {
+        const char* value=getenv(PADVARIABLE);
+        lines=-1;
+        if(value!=NULL && strcmp(value, "auto")!=0) {
+            char* end=NULL;
+            long parsed=strtol(value, &end, 10);
+            if(end==value || *end!='\0' || parsed<0 || parsed>64) {
+                fprintf(stderr, "Unknown %s=%s, it has to be auto or a number of cache lines between 0 and 64\n", PADVARIABLE, value);
+                exit(1);
+            }
+            lines=(int)parsed;
+        }
+    }
+    const int line=CACHELINE/sizeof(float);
+    if(lines<0) {
+        return (cols%(4*line)==0) ? cols+line : cols;
+    }
+    return cols+lines*line;
+}
 /*
  * Name: freeMemory
  * Free the memory allocated in heap, being careful of properly deallocating
@@ -93,6 +254,22 @@ void freeMemory(float** M, int size) {
     }
 }
 
+/*
+ * Name: freeMatrixContiguous
+ * Free a matrix allocated with createFloatMatrixContiguous (one block for the
+ * data and the array of pointers)
+ * Input:
+ *      M (float**) - The allocated in heap matrix
+ * Output: none
+ */
+
+void freeMatrixContiguous(float** M) {
+    if(M!=NULL) {
+        free(M[0]);
+        free(M);
+    }
+}
+
 /*
  * Name: checkSym
  * Verifies if the square matrix in input is symmetric, so the matrix and its
@@ -143,20 +320,34 @@ bool checkSymImpStandard (float** M, int size, int sublength) {
     bool returnBool=true;
     for (int i=0; i<size && returnBool; i+=sublength) {
         for (int j=0; j<=i && returnBool; j+=sublength) {
-            int k_min=MIN(size, i+sublength);
-            int l_min=MIN(size, j+sublength);
-            for (int k=i; k<k_min && returnBool; k++) {
-                //It's guarantee to the algorithm of the subblock that sublength is a multiple of MINIMUMLENGTH
-                for (int l=j; l<l_min && returnBool; l++){
-                    if(ABS_DIFF(M[k][l],M[l][k])>ERROR) {
-                        returnBool=false;
-                    }
-                }
-            }
+            returnBool=checkSymTile(M, size, i, j, sublength);
         }
     }
     return returnBool;
 }
+/*
+ * Name: checkSymTile
+ * Block of checkSymImpStandard: compares the block starting at [i][j] with its mirror starting at [j][i]
+ * Input:
+ *      M (float**) - The allocated in heap matrix
+ *      size (int) - Dimension of the side of the squared matrix
+ *      i, j (int) - Start row and column of the block (multiples of sublength)
+ *      sublength (int) - Blocks of a submatrix
+ * Output: bool (true - The two blocks are mirrored; false - At least one pair is different)
+ */
+bool checkSymTile (float** M, int size, int i, int j, int sublength) {
+    int k_min=MIN(size, i+sublength);
+    int l_min=MIN(size, j+sublength);
+    for (int k=i; k<k_min; k++) {
+        //It's guarantee to the algorithm of the subblock that sublength is a multiple of MINIMUMLENGTH
+        for (int l=j; l<l_min; l++){
+            if(ABS_DIFF(M[k][l],M[l][k])>ERROR) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
 /*
  * Name: checkSymImpRecursive
  * See checkSym - This technique tries to arrive to the lowest matrix possible the 16x16 and from that operate recursively, dividing in these smaller matrix
@@ -261,18 +452,160 @@ bool checkSymOMPLocal (float** M, int size) {
  */
 bool checkSymOMPGlobal (float** M, int size) {
     bool returnCondition=true;
+    TRACE_START(phase);
     #pragma omp parallel for schedule(static) reduction(&&:returnCondition) //nowait
     for(int i=1; i<size; i++) {
         if(returnCondition) {
+            TRACE_START(begin);
             for(int j=0; returnCondition && j<i; j++) {
                 if(ABS_DIFF(M[i][j],M[j][i])>ERROR) {
                     returnCondition=false;
                 }
             }
+            TRACE_STOP("checkRow", i, begin);
         }
     }
+    TRACE_STOP("checkSymOMPGlobal", -1, phase);
     return returnCondition;
 }
+/*
+ * Name: getRowsThreads
+ * Number of threads of runRows: the workers of the pool in PTH_BB, otherwise the OMP team
+ * Output: int - Number of threads
+ */
+static int getRowsThreads(void) {
+    if(defaultPool!=NULL) {
+        return defaultPool->num_threads;
+    }
+    #ifdef _OPENMP
+        return omp_get_max_threads();
+    #else
+        return 1;
+    #endif
+}
+/*
+ * Name: runRows
+ * Executes function on the tiles [0, tiles) (rows or blocks of rows) with the threads of the mode: on the
+ * pool in PTH_BB, so that mode doesn't need the OMP runtime and the rows are touched by the same workers
+ * of the measure, otherwise with the OMP team. Both split the tiles in contiguous ranges, one per thread
+ * like schedule(static), so with tiles=getRowsThreads() the tile i is of the thread i (unless stolen)
+ * Input:
+ *      tiles (long) - Number of tiles
+ *      function (TileFunction) - Function of a tile, thread is the index of the thread
+ *      arg (void*) - Argument of function
+ * Output: none
+ */
+static void runRows(long tiles, TileFunction function, void* arg) {
+    if(defaultPool!=NULL) {
+        threadPoolRun(defaultPool, tiles, function, arg);
+        return;
+    }
+    #pragma omp parallel for schedule(static)
+    for (long tile=0; tile<tiles; tile++) {
+        int thread=0;
+        #ifdef _OPENMP
+            thread=omp_get_thread_num();
+        #endif
+        function(tile, thread, arg);
+    }
+}
+//Rows of a matrix for the helpers executed with runRows (prefilter, flush, warm)
+typedef struct {
+    float** M;
+    int rows;
+    int cols;
+    int chunks;
+    double* sums;
+} RowsJob;
+/*
+ * Name: prefilterChunk
+ * Tile of checkSymPrefilter: a block of rows, with its own column sums (the chunk-th pair of arrays
+ * after the row sums), so no reduction is needed between the threads
+ */
+static void prefilterChunk(long chunk, int thread, void* arg) {
+    (void)thread;
+    RowsJob* job=arg;
+    const int size=job->cols;
+    double* rows=job->sums;
+    double* rowsAbs=job->sums+size;
+    double* cols=job->sums+(size_t)size*(2+2*chunk);
+    double* colsAbs=cols+size;
+    const int first=(int)((long)size*chunk/job->chunks);
+    const int last=(int)((long)size*(chunk+1)/job->chunks);
+    for (int i=first; i<last; i++) {
+        double row=0.0, rowAbs=0.0;
+        const float* r=job->M[i];
+        #pragma omp simd reduction(+:row, rowAbs)
+        for (int j=0; j<size; j++) {
+            double value=r[j];
+            row+=value;
+            rowAbs+=fabs(value);
+            cols[j]+=value;
+            colsAbs[j]+=fabs(value);
+        }
+        rows[i]=row;
+        rowsAbs[i]=rowAbs;
+    }
+}
+/*
+ * Name: checkSymPrefilter
+ * Fast rejection of not symmetric matrices before the exact check. In one sequential pass on the rows
+ * are computed the sum of each row and of each column (vectorized on the row, each block of rows of
+ * runRows with its own column sums), in double with also the sums of the absolute values. If M is symmetric, row i and
+ * column i have the same elements within ERROR, so their sums can differ at most of (n-1)*ERROR plus
+ * the rounding of the two sums (bounded by n*DBL_EPSILON times the sum of the absolute values). A
+ * bigger difference proves that the matrix is not symmetric; otherwise nothing is known and the exact
+ * check has to be done. Sums of the bits as integers would be exact, but the check accepts differences
+ * within ERROR, so they could reject a matrix that the check considers symmetric
+ * Input:
+ *      M (float**) - The allocated in heap matrix
+ *      size (int) - Dimension of the side of the squared matrix
+ * Output: bool (false - Matrix is surely not symmetric; true - It may be symmetric)
+ */
+bool checkSymPrefilter (float** M, int size) {
+    const int chunks=MIN(getRowsThreads(), size);
+    double* sums=calloc((size_t)size*(2+2*chunks), sizeof(double));
+    if(sums==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    RowsJob job={.M=M, .rows=size, .cols=size, .chunks=chunks, .sums=sums};
+    runRows(chunks, prefilterChunk, &job);
+    double* rows=sums;
+    double* rowsAbs=sums+size;
+    double* cols=sums+2*size;
+    double* colsAbs=sums+3*size;
+    //Column sums of the other chunks added to the ones of the first
+    for (int chunk=1; chunk<chunks; chunk++) {
+        const double* other=sums+(size_t)size*(2+2*chunk);
+        for (int j=0; j<size; j++) {
+            cols[j]+=other[j];
+            colsAbs[j]+=other[size+j];
+        }
+    }
+    bool returnBool=true;
+    for (int i=0; i<size && returnBool; i++) {
+        double bound=(size-1)*ERROR+2.0*size*DBL_EPSILON*(rowsAbs[i]+colsAbs[i]);
+        if(fabs(rows[i]-cols[i])>bound) {
+            returnBool=false;
+        }
+    }
+    free(sums);
+    return returnBool;
+}
+/*
+ * Name: prefilterEnabled
+ * If the prefilter is enabled (TRANSPOSE_PREFILTER in the environment), read only once because it's
+ * called inside the measured time
+ * Output: bool - true if enabled
+ */
+static bool prefilterEnabled(void) {
+    static int enabled=-1;
+    if(enabled<0) {
+        enabled=(getenv(PREFILTERVARIABLE)!=NULL);
+    }
+    return enabled;
+}
 /*
  * Name: matTranspose
  * Does a standard transposition. Even if the one with a temporal variable is more
@@ -296,7 +629,8 @@ void matTranspose (float** M, float** T, int size) {
  * allocated with SUBLENGTH constant, is recommended when calling this function to use
  * that variable. The logic is the same as checkSymImpStandard, but with all the elements.
  * I decided to not put an if excluding the elements on the main diagonal, because with high
- * number of matrix, there would have to be taken multiple comparisons
+ * number of matrix, there would have to be taken multiple comparisons.
+ * If (size, sublength) or sublength have a specialized kernel (getFixedKernel, getTileKernel) that is used instead
  * Input:
  *      M (float**) - The allocated in heap matrix (preferable with aligned one for best performance)
  *      size (int) - Dimension of the side of the squared matrix
@@ -304,6 +638,20 @@ void matTranspose (float** M, float** T, int size) {
  * Output: float** - Resulting matrix, after transposition
  */
 void matTransposeImpStandard (float** M, float** T, int size, int sublength) {
+    const MatrixKernel fixed=getFixedKernel(size, sublength);
+    if(fixed!=NULL) {
+        fixed(M, T);
+        return;
+    }
+    const TileKernel kernel=getTileKernel(sublength);
+    if(kernel!=NULL && size%sublength==0) {
+        for (int i=0; i<size; i+=sublength) {
+            for (int j=0; j<size; j+=sublength) {
+                kernel(M, T, j, i, i, j);
+            }
+        }
+        return;
+    }
     for (int i=0; i<size; i+=sublength) {
         for (int j=0; j<size; j+=sublength) {
             int min_k=MIN(size, i+sublength);
@@ -387,7 +735,7 @@ void matTransposeOMPWorkSharing (float** M, float** T, int size) {
 //Because of bottlenecks I tried to optimize it
 /*
  * Name: matTransposeOMPBlockingBased
- * This code applies the BlockBased logic, an possible implementation for OMP. It takes the sequential code and parallelize it. Having all the matrix to loop has previously explained was use collapse to compact the first two loops. The two conditions were precomputed before enter the inner cycles and the innerest cycle was vectorized with #pragma omp simd and with prefetched data
+ * This code applies the BlockBased logic, an possible implementation for OMP. It takes the sequential code and parallelize it. Having all the matrix to loop has previously explained was use collapse to compact the first two loops. The two conditions were precomputed before enter the inner cycles and the innerest cycle was vectorized with #pragma omp simd and with prefetched data. When sublength has a specialized kernel (getTileKernel) and divides size, each block is done by it
  *   Input:
  *      M (float**) - The start allocated in heap matrix
  *      T (float**) - The destination allocated in heap matrix (has to be allocated outside)
@@ -396,9 +744,25 @@ void matTransposeOMPWorkSharing (float** M, float** T, int size) {
  * Output: none
  */
 void matTransposeOMPBlockingBased (float** M, float** T, int size, int sublength) {
+    const TileKernel kernel=getTileKernel(sublength);
+    const long blocks=(size+sublength-1)/sublength;
+    TRACE_START(phase);
+    if(kernel!=NULL && size%sublength==0) {
+        #pragma omp parallel for collapse(2) schedule(static) shared(M, T)
+        for (int i=0; i<size; i+=sublength) {
+            for (int j=0; j<size; j+=sublength) {
+                TRACE_START(begin);
+                kernel(M, T, j, i, i, j);
+                TRACE_STOP("transposeTile", i/sublength*blocks+j/sublength, begin);
+            }
+        }
+        TRACE_STOP("matTransposeOMPBlockingBased", -1, phase);
+        return;
+    }
     #pragma omp parallel for collapse(2) schedule(static) shared(M, T)
     for (int i=0; i<size; i+=sublength) {
         for (int j=0; j<size; j+=sublength) {
+            TRACE_START(begin);
             /*Used for small blocking and small n° threads*/
             //int smaller_block=sublength/2;
             int k_min=MIN(size, i+sublength);
@@ -411,647 +775,1977 @@ void matTransposeOMPBlockingBased (float** M, float** T, int size, int sublength
                     T[k][l]=M[l][k];
                 }
             }
-            
+            TRACE_STOP("transposeTile", i/sublength*blocks+j/sublength, begin);
         }
     }
+    TRACE_STOP("matTransposeOMPBlockingBased", -1, phase);
 }
 /*
- * Name: PrintMatrix
- * Prints out on stdout all the Matrix indexed. This was used for control to verify that the program worked for small matrices. It's not present in the running code
- *   Input:
- *      M (float**) - The start allocated in heap matrix
- *      size(int) - Dimension of the matrix
+ * Name: transposeLevel
+ * One level of matTransposeHierarchical on the region [r0, r1) x [c0, c1) of T: it's split in blocks of
+ * lengths[level] and each block goes to the next level, the blocks of the last level are done by the
+ * specialized kernel of their size (getTileKernel), unrolled at compile time in register micro-tiles
+ * Input:
+ *      M (float**) - The start matrix
+ *      T (float**) - The destination matrix
+ *      r0, r1 (int) - Rows of T of the region
+ *      c0, c1 (int) - Columns of T of the region
+ *      lengths (const int*) - Block length of each level
+ *      level (int) - Current level
+ *      levels (int) - Number of levels
  * Output: none
  */
-void printMatrix(float** M, int size) {
-    for (int i=0; i<size; i++) {
-        for(int j=0; j<size; j++) {
-            printf("%.2f\t", M[i][j]);
+static void transposeLevel(float** M, float** T, int r0, int r1, int c0, int c1, const int* lengths, int level, int levels) {
+    if(level==levels) {
+        const TileKernel kernel=getTileKernel(r1-r0);
+        if(kernel!=NULL && r1-r0==c1-c0) {
+            kernel(M, T, c0, r0, r0, c0);
+            return;
+        }
+        for (int k=r0; k<r1; k++) {
+            #pragma omp simd
+            for (int l=c0; l<c1; l++) {
+                T[k][l]=M[l][k];
+            }
+        }
+        return;
+    }
+    const int length=lengths[level];
+    for (int i=r0; i<r1; i+=length) {
+        for (int j=c0; j<c1; j+=length) {
+            transposeLevel(M, T, i, MIN(r1, i+length), j, MIN(c1, j+length), lengths, level+1, levels);
         }
-        printf("\n");
     }
 }
 /*
- * Name: control
- * Another control algorithm for verifying that the transposition happened correctly. Happened a transposition of
+ * Name: transposeTile<S>
+ * Kernels generated for each tile size S of TILE_KERNELS: S and the loop bounds are constants, so the
+ * compiler unrolls and vectorizes them completely without checks
+ */
+#define DEFINE_TILE_KERNEL(S) \
+static void transposeTile##S(float** M, float** T, int m_r, int m_c, int t_r, int t_c) { \
+    for (int k=0; k<S; k++) { \
+        float* restrict t_row=T[t_r+k]+t_c; \
+        _Pragma("omp simd") \
+        for (int l=0; l<S; l++) { \
+            t_row[l]=M[m_r+l][m_c+k]; \
+        } \
+    } \
+}
+TILE_KERNELS(DEFINE_TILE_KERNEL)
+/*
+ * Name: matTransposeFixed<N>x<S>
+ * Kernels generated for each pair of FIXED_KERNELS: sequential transposition of a N x N matrix with
+ * tiles S x S, all the bounds are constants
+ */
+#define DEFINE_FIXED_KERNEL(N, S) \
+static void matTransposeFixed##N##x##S(float** M, float** T) { \
+    for (int i=0; i<N; i+=S) { \
+        for (int j=0; j<N; j+=S) { \
+            transposeTile##S(M, T, j, i, i, j); \
+        } \
+    } \
+}
+FIXED_KERNELS(DEFINE_FIXED_KERNEL)
+/*
+ * Name: getTileKernel
+ * Dispatch of the specialized tile kernels
+ * Input: sublength (int) - Dimension of the submatrix
+ * Output: TileKernel - The kernel for sublength x sublength tiles, NULL if there isn't one
+ */
+TileKernel getTileKernel(int sublength) {
+    switch (sublength) {
+        #define CASE_TILE_KERNEL(S) case S: return transposeTile##S;
+        TILE_KERNELS(CASE_TILE_KERNEL)
+        #undef CASE_TILE_KERNEL
+        default: return NULL;
+    }
+}
+/*
+ * Name: getFixedKernel
+ * Dispatch of the specialized whole matrix kernels on (n, sublength)
+ * Input:
+ *      n (int) - Size of the matrix
+ *      sublength (int) - Dimension of the submatrix
+ * Output: MatrixKernel - The kernel, NULL if the pair isn't in FIXED_KERNELS
+ */
+MatrixKernel getFixedKernel(int n, int sublength) {
+    #define IF_FIXED_KERNEL(N, S) if(n==N && sublength==S) return matTransposeFixed##N##x##S;
+    FIXED_KERNELS(IF_FIXED_KERNEL)
+    #undef IF_FIXED_KERNEL
+    return NULL;
+}
+/*
+ * Name: matTransposeHierarchical
+ * See matTransposeOMPBlockingBased - Block-based transposition with a block for each level of memory:
+ * the matrix is split in super-blocks of SUPERLENGTH (LLC), given to the threads with a static schedule
+ * in row-major order of T, so each thread writes a few rows of T at a time (same DRAM pages and TLB
+ * entries), each super-block in panels of PANELLENGTH (L2) and each panel in tiles of sublength (L1),
+ * done by the specialized kernel that keeps register micro-tiles (a separate call for each 8 x 8 block
+ * was slower). Super-blocks are halved until each thread has at least one
  *   Input:
  *      M (float**) - The start allocated in heap matrix
- *      T (float**) - The destination allocated in heap matrix
- *      size(int) - Dimension of the matrix
+ *      T (float**) - The destination allocated in heap matrix (has to be allocated outside)
+ *      size (int) - Dimension of the matrix
+ *      sublength (int) - Dimension of the submatrix (L1 tile)
  * Output: none
  */
-void control(float** M, float** T, int N) {
-    printf("[%d][%d] M: %.2f T: %.2f\n", 1, 2, M[1][2], T[2][1]);
-    printf("[%d][%d] M: %.2f T: %.2f\n", N/2-4, N/2+2, M[N/2-4][N/2+2], T[N/2+2][N/2-4]);
-    printf("[%d][%d] M: %.2f T: %.2f\n", N-5, N-3, M[N-5][N-3], T[N-3][N-5]);
+void matTransposeHierarchical (float** M, float** T, int size, int sublength) {
+    int threads=1;
+    #ifdef _OPENMP
+        threads=omp_get_max_threads();
+    #endif
+    const int tile=MAX(MIN(sublength, size), MINIMUMSUBLENGTH);
+    const int panel=MAX(MIN(PANELLENGTH, size), tile);
+    int super=MAX(MIN(SUPERLENGTH, size), panel);
+    while(super>panel && (long)((size+super-1)/super)*((size+super-1)/super)<threads) {
+        super/=2;
+    }
+    const int lengths[2]={panel, tile};
+    const long blocks=(size+super-1)/super;
+    TRACE_START(phase);
+    #pragma omp parallel for schedule(static)
+    for (long b=0; b<blocks*blocks; b++) {
+        TRACE_START(begin);
+        const int i=(int)(b/blocks)*super;
+        const int j=(int)(b%blocks)*super;
+        transposeLevel(M, T, i, MIN(size, i+super), j, MIN(size, j+super), lengths, 0, 2);
+        TRACE_STOP("superBlock", b, begin);
+    }
+    TRACE_STOP("matTransposeHierarchical", -1, phase);
 }
 /*
- *  Name: clearCache
- *  Function that tries to free memory for the various chunk of memory in order to minimize the number of more efficient simulation. This isn't guarantee to always work, but it brought less outliers.
- *  Input:
- *      dimCache (long long int) - Dimension of the cache we would like to clear
- *  Output: none
+ * Name: matTransposeTile
+ * Block-based transposition of a rectangular tile of M in a position of T that can be different from
+ * the mirrored one: T[t_r+k][t_c+l]=M[m_r+l][m_c+k]. It's the kernel of matTransposeOMPBlockingBased
+ * without the parallel region, so it can be called on a single tile by who is distributing the work
+ * (MPI ranks packing the tile to send). The tile doesn't need to be a multiple of sublength, the full
+ * sublength x sublength blocks go to the specialized kernel if there is one
+ *   Input:
+ *      M (float**) - The start allocated in heap matrix
+ *      T (float**) - The destination allocated in heap matrix (has to be allocated outside)
+ *      m_r, m_c (int) - Row and column of M where the tile starts
+ *      t_r, t_c (int) - Row and column of T where the transposed tile starts
+ *      rows, cols (int) - Dimensions of the tile in M (in T will be cols x rows)
+ *      sublength (int) - Dimension of the submatrix
+ * Output: none
  */
-void clearAllCache(void) {
-    float* cacheL1d, *cacheL1i, *cacheL2, *cacheL3;
-    if (posix_memalign((void**)&cacheL1d, 64, CACHESIZEL1D) != 0 ||
-            posix_memalign((void**)&cacheL1i, 64, CACHESIZEL1I) != 0 ||
-            posix_memalign((void**)&cacheL2, 64, CACHESIZEL2) != 0 ||
-            posix_memalign((void**)&cacheL3, 64, CACHESIZEL3) != 0) {
-            fprintf(stderr, "Failed to allocate aligned memory\n");
-            exit(1);
+void matTransposeTile (float** M, float** T, int m_r, int m_c, int t_r, int t_c, int rows, int cols, int sublength) {
+    const TileKernel kernel=getTileKernel(sublength);
+    for (int i=0; i<cols; i+=sublength) {
+        for (int j=0; j<rows; j+=sublength) {
+            int k_min=MIN(cols, i+sublength);
+            int l_min=MIN(rows, j+sublength);
+            if(kernel!=NULL && k_min-i==sublength && l_min-j==sublength) {
+                kernel(M, T, m_r+j, m_c+i, t_r+i, t_c+j);
+                continue;
+            }
+            for (int k=i; k<k_min; k++) {
+                float* t_row=T[t_r+k]+t_c;
+                #pragma omp simd
+                for (int l=j; l<l_min; l++) {
+                    t_row[l]=M[m_r+l][m_c+k];
+                }
+            }
         }
-    for (int i = 0; i < CACHESIZEL1D / sizeof(float); ++i) {
-        cacheL1d[i] = 1.0f;
     }
-    for (int i = 0; i < CACHESIZEL1I / sizeof(float); ++i) {
-        cacheL1i[i] = 1.0f;
-    }
-    for (int i = 0; i < CACHESIZEL2 / sizeof(float); ++i) {
-        cacheL2[i] = 1.0f;
-    }
-    for (int i = 0; i < CACHESIZEL3 / sizeof(float); ++i) {
-        cacheL3[i] = 1.0f;
-    }
-    free(cacheL1d);
-    free(cacheL1i);
-    free(cacheL2);
-    free(cacheL3);
 }
 /*
- *  Name: getSequential
- *  Function that retrieves the sequential execution time for a given dimension and test from a file.
- *  Input:
- *      dim (int) - Dimension for which we are retrieving the sequential time
- *      test (int) - Test identifier to filter the relevant entry
- *  Output:
- *      double - Returns the average time for the sequential execution. If not found in the file, it returns 0.00
+ * Name: inPlaceSource
+ * Position of the element that goes in position p when a rows x cols matrix stored by rows becomes
+ * its cols x rows transpose: p is [j][i] of the transpose, so it comes from [i][j] of the start one
  */
-double getSequential(const int dim, const int test) {
-    char line[256];
-    int findex, fmode, fdimension, ftest, fsamples, fthreads;
-    char fcompile[20];
-    double favg_time=0.0, fseq_time, fspeedup, fefficiency;
-    FILE* file=fopen(FILENAMESEQ, "a+");
-    if(file==NULL) {
-        fprintf(stderr, "Couldn't open or create file %s\n", FILENAMESEQ);
+static inline long inPlaceSource(long p, int rows, int cols) {
+    return (p%rows)*cols+p/rows;
+}
+/*
+ * Name: matTransposeInPlace
+ * Transposition without a second matrix of a rows x cols matrix stored contiguously by rows: at the
+ * end the same buffer holds the cols x rows transpose. The positions move along cycles of the
+ * permutation p -> inPlaceSource(p), which are independent:
+ *      1. A pass in increasing order with a bit-vector of visited positions finds the leader (smallest
+ *         position) of each cycle: a position not yet visited is the smallest of its cycle, whose
+ *         positions are then marked. Only indexes are computed, the data isn't touched
+ *      2. The cycles are rotated in parallel, each starting from its leader
+ * The extra memory is 2 bits per element. If the matrix is square the cycles are the pairs [i][j],
+ * [j][i], so the mirrored blocks are swapped in parallel without any extra memory.
+ * It doesn't exit when the bit-vectors can't be allocated, because it's called also by the Python
+ * extension, which has to raise MemoryError instead of killing the interpreter
+ * Input:
+ *      A (float*) - The matrix, rows*cols contiguous floats
+ *      rows (int) - Number of rows (of the transpose at the end will be the columns)
+ *      cols (int) - Number of columns
+ *      sublength (int) - Dimension of the submatrix for the square case (at least 1)
+ * Output: bool - true if transposed, false if the memory wasn't enough (A is untouched)
+ */
+bool matTransposeInPlace (float* A, int rows, int cols, int sublength) {
+    if(rows<0 || cols<0 || sublength<=0) {
+        fprintf(stderr, "Error, in-place transposition of %d x %d with block %d\n", rows, cols, sublength);
         exit(1);
     }
-    bool found=false;
-    fgets(line, sizeof(line), file);
-    while(!found && (fscanf(file, "%d %10s %d %d %d %d %d %lf %lf %lf %lf%%", &findex, fcompile, &fmode, &fdimension, &ftest,
-          &fsamples, &fthreads, &favg_time, &fseq_time,
-          &fspeedup, &fefficiency)==11)) {
-        if(fmode==1 && (strcmp(fcompile, "SO0")==0) && fdimension==dim && ftest==test) {
-            found=true;
+    if(rows==cols) {
+        const int n=rows;
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int i=0; i<n; i+=sublength) {
+            for (int j=0; j<=i; j+=sublength) {
+                int k_min=MIN(n, i+sublength);
+                int l_min=MIN(n, j+sublength);
+                for (int k=i; k<k_min; k++) {
+                    //On the diagonal block only the elements under the diagonal
+                    int l_end=(i==j) ? k : l_min;
+                    for (int l=j; l<l_end; l++) {
+                        float temp=A[(long)k*n+l];
+                        A[(long)k*n+l]=A[(long)l*n+k];
+                        A[(long)l*n+k]=temp;
+                    }
+                }
+            }
         }
+        return true;
     }
-    fclose(file);
-    if(found) {
-        return favg_time;
+    const long size=(long)rows*cols;
+    //A row or a column is already its own transpose (also with no elements, calloc could return NULL)
+    if(rows<=1 || cols<=1) {
+        return true;
     }
-    else {
-        return 0.00;
-       /* clearAllCache();
-        char command[256];
-        //snprintf(command, sizeof(command), "gcc -O0 functions.c transpose.c -o transpose -lm");
-       // executeCommand(command);
-        float get_integer=(log(dim)/log(2));
-        snprintf(command, sizeof(command), "taskset -c 0 ./transpose SO0 1 %d %d %d", (int)get_integer, test, samples);
-        executeCommand(command);
-        return getSequential(dim, test, samples);*/
+    const long words=(size+63)/64;
+    uint64_t* visited=calloc(words, sizeof(uint64_t));
+    uint64_t* leaders=calloc(words, sizeof(uint64_t));
+    if(visited==NULL || leaders==NULL) {
+        free(visited);
+        free(leaders);
+        return false;
+    }
+    //The first and the last positions never move
+    for (long start=1; start<size-1; start++) {
+        if(visited[start/64]&(1ULL<<(start%64))) {
+            continue;
+        }
+        leaders[start/64]|=1ULL<<(start%64);
+        long p=start;
+        do {
+            visited[p/64]|=1ULL<<(p%64);
+            p=inPlaceSource(p, rows, cols);
+        } while(p!=start);
+    }
+    free(visited);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (long w=0; w<words; w++) {
+        uint64_t bits=leaders[w];
+        while(bits!=0) {
+            long start=w*64+__builtin_ctzll(bits);
+            bits&=bits-1;
+            float temp=A[start];
+            long p=start;
+            long source=inPlaceSource(p, rows, cols);
+            while(source!=start) {
+                A[p]=A[source];
+                p=source;
+                source=inPlaceSource(p, rows, cols);
+            }
+            A[p]=temp;
+        }
     }
+    free(leaders);
+    return true;
 }
-/* NO MORE USED NOT MORE USEFUL
- *  Name: executeCommand
- *  Function that executes a given command in the system shell. If the command fails (i.e., returns a non-zero value), it reports an error and exits the program.
- *  Input:
- *      command (char[]) - The command to be executed as a string
- *  Output: none
- *      Exits the program if the command execution fails.
- NO MORE USED NOT MORE USEFUL
+/*
+ * Name: floatToBF16
+ * Conversion float -> bfloat16 (the upper 16 bits of the float) rounding to the nearest even
+ * Input: f (float) - The value
+ * Output: uint16_t - The bits of the bfloat16
  */
-void executeCommand(char command[]) {
-    int result=system(command);
-    if (result != 0) {
-       fprintf(stderr, "Error executing ./transpose command\n");
-       exit(1);
-   }
+uint16_t floatToBF16(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    if((x&0x7FFFFFFF)>0x7F800000) {
+        return (uint16_t)((x>>16)|0x40); //NaN stays NaN
+    }
+    x+=0x7FFF+((x>>16)&1);
+    return (uint16_t)(x>>16);
 }
 /*
- *  Name: openFile
- *  Function that opens a file and appends performance data. Depending on the mode and type, it computes speedup and efficiency, then writes on the file the input parameters and calculated information. Writes performance data to the file. If the file is empty, it writes a header before appending data.
- *  Input:
- *      filename (const char*) - The name of the file to open.
- *      code (const char*) - The code or label to be recorded in the file
- *      mode (int) - The mode of the computation (SO0 for sequential - see readMe for others)
- *      dim (int) - Dimension Size
- *      test (int) - The test case identifier
- *      samples (int) - The number of samples
- *      num_threads (int) - The number of threads used
- *      avg_time (double) - The average time taken for the computation
- *      type (int) - Determines the type of output file (0 - times, 1- average)
- *  Output: none
+ * Name: bf16ToFloat
+ * Conversion bfloat16 -> float, exact
+ * Input: h (uint16_t) - The bits of the bfloat16
+ * Output: float - The value
  */
-void openFile(const char* filename, const char* code, const int mode, const int dim, const int test, const int samples, const int num_threads, double avg_time, int type) {
-    FILE* file=fopen(filename, "a+"); //read and append
-    if(file==NULL) {
-        fprintf(stderr, "Couldn't open or create %s\n", filename);
-        exit(1);
-    }
-    //int lines=countFile(file);
-    FILE* wc=NULL;
-    if(type==1) {
-        wc=popen("wc -l < resultsGeneral.csv", "r");
-    }
-    else{
-        if (type==0) {
-            wc=popen("wc -l < timesGeneral.csv", "r");
-        }
-    }
-    if (wc==NULL) {
-        fprintf(stderr, "Error running wc -l\n");
-        fclose(file);
-        exit(1);
+float bf16ToFloat(uint16_t h) {
+    uint32_t x=(uint32_t)h<<16;
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+/*
+ * Name: floatToHalf
+ * Conversion float -> IEEE half (fp16) rounding to the nearest even, with subnormals, overflow to infinity and NaN
+ * Input: f (float) - The value
+ * Output: uint16_t - The bits of the half
+ */
+uint16_t floatToHalf(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    const uint32_t sign=(x>>16)&0x8000;
+    const uint32_t mant=x&0x7FFFFF;
+    const int exp=(int)((x>>23)&0xFF)-127+15;
+    if(((x>>23)&0xFF)==0xFF) {
+        return (uint16_t)(sign|0x7C00|(mant!=0 ? 0x200 : 0));
     }
-    int lines;
-    fscanf(wc, "%d", &lines);
-    fclose(wc);
-    if(lines==0){
-        lines=1;
+    if(exp>=31) {
+        return (uint16_t)(sign|0x7C00);
     }
-    double seq_time = 0.0;
-    double speedup=0.0;
-    double efficiency=0.0;
-    if(mode!=SEQ && type==1) {
-        fclose(file);
-        seq_time=getSequential(dim, test);
-        file=fopen(filename, "a+"); //read and append
-        if(file==NULL) {
-            fprintf(stderr, "Couldn't open or create %s\n", filename);
-            exit(1);
+    if(exp<=0) {
+        if(exp<-10) {
+            return (uint16_t)sign;
         }
-        speedup=seq_time/avg_time;
-        efficiency=speedup/num_threads*100;
-    }
-    else {
-        seq_time=avg_time;
-        speedup=seq_time/avg_time;
-        efficiency=speedup/num_threads*100;
-    }
-    fseek(file, 0, SEEK_END);
-    long long file_size=ftell(file);
-    if(file_size==0 && type==1) {
-        fprintf(file, "%-10s %-10s %-5s %-10s %-10s %-10s %-10s %-15s %-15s %-10s %-10s\n", "N°", "Compile", "Mode", "Dimension", "Test_Mode", "Samples", "Threads", "Avg_Time(s)", "Seq_time(s)", "Speedup", "Efficiency");
-    }
-    else {
-        if(file_size==0 && type==0) {
-            fprintf(file, "%-10s %-10s %-5s %-10s %-10s %-10s %-10s %-15s\n", "N°", "Compile", "Mode", "Dimension", "Test_Mode", "Samples", "Threads", "Time(s)");
+        //Subnormal: the implicit bit is shifted in the mantissa
+        const uint32_t full=mant|0x800000;
+        const int shift=14-exp;
+        uint32_t half=full>>shift;
+        const uint32_t rest=full&((1u<<shift)-1);
+        const uint32_t middle=1u<<(shift-1);
+        if(rest>middle || (rest==middle && (half&1))) {
+            half++;
         }
+        return (uint16_t)(sign|half);
     }
-    char void_element='-';
-    if(type==0) {
-        fprintf(file, "%-10d %-10s %-5d %-10d %-10d %-10d %-10d %-15.12lf\n", lines, code, mode, dim, test, samples, num_threads, avg_time);
+    //A carry of the rounding goes in the exponent, up to infinity
+    uint32_t half=sign|((uint32_t)exp<<10)|(mant>>13);
+    const uint32_t rest=mant&0x1FFF;
+    if(rest>0x1000 || (rest==0x1000 && (half&1))) {
+        half++;
     }
-    else {
-        if(seq_time<1e-9) {
-            fprintf(file, "%-10d %-10s %-5d %-10d %-10d %-10d %-10d %-15.12f %-15c %-10c %-10c%%\n", lines, code, mode, dim, test, samples, num_threads, avg_time, void_element, void_element, void_element);
+    return (uint16_t)half;
+}
+/*
+ * Name: halfToFloat
+ * Conversion IEEE half (fp16) -> float, exact
+ * Input: h (uint16_t) - The bits of the half
+ * Output: float - The value
+ */
+float halfToFloat(uint16_t h) {
+    const uint32_t sign=(uint32_t)(h&0x8000)<<16;
+    uint32_t exp=(h>>10)&0x1F;
+    uint32_t mant=h&0x3FF;
+    uint32_t x;
+    if(exp==0) {
+        if(mant==0) {
+            x=sign;
         }
         else {
-            fprintf(file, "%-10d %-10s %-5d %-10d %-10d %-10d %-10d %-15.12lf %-15.12lf %-10.2lf %-10.2lf%%\n", lines, code, mode, dim, test, samples, num_threads, avg_time, seq_time, speedup, efficiency);
+            //Subnormal: normalized in the float
+            exp=127-15+1;
+            while(!(mant&0x400)) {
+                mant<<=1;
+                exp--;
+            }
+            x=sign|(exp<<23)|((mant&0x3FF)<<13);
         }
     }
-    fclose(file);
-}
-/*
- *  Name: inputParameters
- *  Function that checks the number of arguments passed to the program (6 or 7 ok, less exits.
- *  Input:
- *      argc (int) - The number of arguments passed to the program.
- *  Output: none
- */
-void inputParameters(int argc) {
-    if(argc!=6 && argc!=7) {
-        fprintf(stderr, "Invalid parameters. They are:\n\n(1) Code identifying the compilation (everything is acceptable, default one is SO0, is used as reference for sequential code -O0 and will be used as comparison for speedup and efficiency)\n\n(2)Integer for mode. The modes are:\n1. Sequential Code\n2. Implicit Parallelism (Blocking)\n3. Implicit Parallelism (Recursive)\n4. Explicit Parallelism (OMP - SymLocalVar + Work-Sharing)\n5. Explicit Paralellelism (OMP - SymLocalVar + Block-Based)\n6. Explicit Parallelism (OMP - SymGeneralVar + Work-Sharing)\n7. Explicit Paralellelism (OMP - SymGeneralVar + Block-Based)\n\n(3) Exponential of 2 from 4 to 12 (16->4, 64->6, 1024->10, 4096->12)\n\n(4) Testing:\n0. Matrix is generated randomly\n1. A default test matrix is generated according to an algorithm (used for testing, with one interaction in checkSym and Transposition)\n2. A default test symmetric matrix (only checkSym works)\n3. The worst case scenario with a matrix, with only one element different not on main diagonal\n\n(5) Number of samples (>=25)\n\n(6) Number of Threads - If selected modes from 1 to 3 is not required, it will be ignored, but if are the others (OMP) it is important.\n\n");
-        exit(1);
+    else if(exp==31) {
+        x=sign|0x7F800000|(mant<<13);
+    }
+    else {
+        x=sign|((exp+127-15)<<23)|(mant<<13);
     }
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
 }
 /*
- *  Name: valueInputed
- *  Function that processes and validates the input values based on the argument provided. It checks if the input values are within valid ranges for different parameters (mode, dimension, test, samples, and number of threads). If any value is invalid, it prints an error message and exits the program.
- *  Input:
- *      argc (int) - The number of command-line arguments passed to the program
- *      argv (const char*) - A string representing the argument value to be process
- *      value (int) - The specific value identifying which input parameter is being validated (2. mode, 3. dimension, 4. test, 5. samples, 6. n° threads)
- *  Output:
- *      returnValue (int) - The validated integer value for the corresponding parameter
+ * Name: storeRow
+ * Last step of matOmatcopy on a piece of a row of B: out=values+beta*out, converted in the type of B.
+ * The switch is done once for each piece, so the loops stay vectorizable. With beta=0 B isn't read
+ * (as in BLAS it can be not initialized)
+ * Input:
+ *      row (void*) - The row of B, already moved to the first column of the piece
+ *      values (const float*) - alpha*op(A) of the piece
+ *      length (int) - Length of the piece
+ *      beta (float) - Scalar of B
+ *      type (OutputType) - Type of the elements of B
+ * Output: none
  */
-int valueInputed(int argc, const char* argv, int value) {
-    int returnValue=-1;
-    if(value>=2 && value<=6) {
-        switch (value) {
-            case 2: {
-               returnValue=atoi(argv);
-                if (returnValue<=START || returnValue>=END) {
-                    fprintf(stderr, "1. Sequential Code\n2. Implicit Parallelism (Blocking)\n3. Implicit Parallelism (Recursive)\n4. Explicit Parallelism (OMP - SymLocalVar + Work-Sharing)\n5. Explicit Paralellelism (OMP - SymLocalVar + Block-Based)\n6. Explicit Parallelism (OMP - SymGeneralVar + Work-Sharing)\n7. Explicit Paralellelism (OMP - SymGeneralVar + Block-Based)\n\n");
-                    exit(1);
-                }
-            }
-                break;
-            case 3: {
-                returnValue=pow(2, atoi(argv));
-                if (returnValue<MIN_SIZE || returnValue>MAX_SIZE) {
-                    fprintf(stderr, "Invalid dimension, it has to be a power of 2 between 4 and 12. Insert the exponential\n\n");
-                    exit(1);
+static void storeRow(void* row, const float* values, int length, float beta, OutputType type) {
+    switch (type) {
+        case OUT_F32: {
+            float* out=row;
+            if(beta==0.0f) {
+                #pragma omp simd
+                for (int l=0; l<length; l++) {
+                    out[l]=values[l];
                 }
             }
-                break;
-            case 4: {
-                returnValue=atoi(argv);
-                if(returnValue>3 || returnValue<0) {
-                    fprintf(stderr, "Invalid testing, it has to be:\n\n0. (Random)\n1. (Standard Test No Symmetric)\n2. (Standard Test Symmetric)\n 3 (Worst Case Scenario)\n\n");
-                    exit(1);
+            else {
+                #pragma omp simd
+                for (int l=0; l<length; l++) {
+                    out[l]=values[l]+beta*out[l];
                 }
             }
-                break;
-            case 5: {
-                returnValue=atoi(argv);
-                if(returnValue<25) {
-                    fprintf(stderr, "Invalid samples number, it has to be at least of 25\n\n");
-                    exit(1);
-                }
+        }
+            break;
+        case OUT_BF16: {
+            uint16_t* out=row;
+            for (int l=0; l<length; l++) {
+                out[l]=floatToBF16(beta==0.0f ? values[l] : values[l]+beta*bf16ToFloat(out[l]));
             }
-                break;
-            case 6: {
-                returnValue=atoi(argv);
-                if (returnValue<=0 && argc==7) {
-                    fprintf(stderr, "Invalid number of threads inserted, it has to be positive\n\n");
-                    exit(1);
-                }
-                else {
-                    if (argc!=7) {
-                        fprintf(stderr, "Invalid parameters. They are:\n\n(1) Code identifying the compilation (everything is acceptable, default one is SO0, is used as reference for sequential code -O0 and will be used as comparison for speedup and efficiency)\n\n(2)Integer for mode. The modes are:\n1. Sequential Code\n2. Implicit Parallelism (Blocking)\n3. Implicit Parallelism (Recursive)\n4. Explicit Parallelism (OMP - SymLocalVar + Work-Sharing)\n5. Explicit Paralellelism (OMP - SymLocalVar + Block-Based)\n6. Explicit Parallelism (OMP - SymGeneralVar + Work-Sharing)\n7. Explicit Paralellelism (OMP - SymGeneralVar + Block-Based)\n\n(3) Exponential of 2 from 4 to 12 (16->4, 64->6, 1024->10, 4096->12)\n\n(4) Testing:\n0. Matrix is generated randomly\n1. A default test matrix is generated according to an algorithm (used for testing, with one interaction in checkSym and Transposition)\n2. A default test symmetric matrix (only checkSym works)\n3. The worst case scenario with a matrix, with only one element different not on main diagonal\n\n(5) Number of samples (>=25)\n\n(6) Number of Threads - If selected modes from 1 to 3 is not required, it will be ignored, but if are the others (OMP) it is important.\n\n");
-                        exit(1);
-                    }
-                }
+        }
+            break;
+        case OUT_F16: {
+            uint16_t* out=row;
+            for (int l=0; l<length; l++) {
+                out[l]=floatToHalf(beta==0.0f ? values[l] : values[l]+beta*halfToFloat(out[l]));
             }
-                break;
-            default:
-                exit(1);
-                break;
         }
+            break;
+        default:
+            fprintf(stderr, "Unexpected Error\n");
+            exit(1);
     }
-    return returnValue;
 }
 /*
- *  Name: threadInit
- *  Function that initializes the number of threads based on the specified mode (if Sequential or Esplicit is 1 thread for the others it sets the number of threads accordingly to the inputed parameters)
- *  Input:
- *      argv (const char*) - Command-line argument value representing the number of threads
- *      argc (int) - Number of command-line arguments
- *      mode (int) - Mode specifying the type of execution (as described on readME)
- *  Output:
- *      NUM_THREADS (int) - The number of threads to be used for the parallel execution
+ * Name: matOmatcopy
+ * Fused version of the transposition with the pass that usually comes before or after it (as omatcopy
+ * of BLAS extensions): B=alpha*op(A)+beta*B, where op is the transposition or nothing, and B is stored
+ * in float, bfloat16 or half. Scaling, accumulation and conversion are done on each tile while it's in
+ * L1, so there is a single pass on the memory instead of two or three. The transposition goes by blocks
+ * of sublength as matTransposeOMPBlockingBased, in parallel with OMP; with alpha=1, beta=0 and float
+ * output it is just matTransposeTile on each block (specialized kernels)
+ * Input:
+ *      op (MatrixOp) - OP_NONE (B is rows x cols) or OP_TRANS (B is cols x rows)
+ *      rows, cols (int) - Dimensions of A
+ *      alpha (float) - Scalar of A
+ *      A (float**) - The start matrix
+ *      beta (float) - Scalar of B, if 0 B isn't read
+ *      B (void**) - The rows of the destination, of float or uint16_t depending on type
+ *      type (OutputType) - Type of the elements of B
+ *      sublength (int) - Dimension of the submatrix, at most MAXIMUMSUBLENGTH
+ * Output: none
  */
-int threadInit(const char* argv, int argc, int mode) {
-    int NUM_THREADS;
-    if(mode>=OMP_LOC_WS && mode<END){
-        #ifdef _OPENMP
-            NUM_THREADS=valueInputed(argc, argv, 6);
-            printf("%d\n", NUM_THREADS);
-            omp_set_num_threads(NUM_THREADS);
-            #pragma omp parallel
-            {
-                printf("Thread %d out of %d threads\n", omp_get_thread_num(), omp_get_num_threads());
+void matOmatcopy (MatrixOp op, int rows, int cols, float alpha, float** A, float beta, void** B, OutputType type, int sublength) {
+    if(sublength<1 || sublength>MAXIMUMSUBLENGTH) {
+        fprintf(stderr, "Error, the submatrix has to be between 1 and %d\n", MAXIMUMSUBLENGTH);
+        exit(1);
+    }
+    const size_t element=(type==OUT_F32) ? sizeof(float) : sizeof(uint16_t);
+    if(op==OP_NONE) {
+        #pragma omp parallel for schedule(static)
+        for (int i=0; i<rows; i++) {
+            float values[MAXIMUMSUBLENGTH];
+            for (int j=0; j<cols; j+=sublength) {
+                const int length=MIN(sublength, cols-j);
+                #pragma omp simd
+                for (int l=0; l<length; l++) {
+                    values[l]=alpha*A[i][j+l];
+                }
+                storeRow((char*)B[i]+element*j, values, length, beta, type);
             }
-            printf("\n");
-        #else
-            fprintf(stderr,"Forgot -fopenmp flag for MODE=%d, please to run in this mode insert that flag\n\n", mode);
-            exit(1);
-        #endif
+        }
+        return;
     }
-    else {
-        #ifdef _OPENMP
-                NUM_THREADS=1;
-        #else
-            fprintf(stderr,"Forgot -fopenmp flag for MODE=%d, please to run in this mode insert that flag\n\n", mode);
-            exit(1);
-        #endif
+    const bool plain=(alpha==1.0f && beta==0.0f && type==OUT_F32);
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int i=0; i<cols; i+=sublength) {
+        for (int j=0; j<rows; j+=sublength) {
+            const int k_min=MIN(cols, i+sublength);
+            const int l_min=MIN(rows, j+sublength);
+            if(plain) {
+                matTransposeTile(A, (float**)B, j, i, i, j, l_min-j, k_min-i, sublength);
+                continue;
+            }
+            float values[MAXIMUMSUBLENGTH];
+            for (int k=i; k<k_min; k++) {
+                for (int l=j; l<l_min; l++) {
+                    values[l-j]=alpha*A[l][k];
+                }
+                storeRow((char*)B[k]+element*j, values, l_min-j, beta, type);
+            }
+        }
     }
-    return NUM_THREADS;
 }
 /*
- *  Name: allocateMatrixPerMode
- *  Function that allocates a matrix based on the specified mode. The function chooses the type of matrix allocation (standard/aligned) depending on the execution mode (sequential standard, others aligned). For sequential execution, it allocates a regular square matrix.
- *  Input:
- *      mode (Mode) - The execution mode that determines how the matrix should be allocated. Different modes require different types of matrix allocation (regular or aligned).
- *      n (int) - Size of the matrix
- *      sublength (int) - aligned memory allocation in parallel modes
- *  Output:
- *      M (float**) - The allocated matrix reffered
+ * Name: transposeStrided
+ * Transposition of a rows x cols matrix that isn't float** but a pointer with a leading dimension,
+ * as the 2D slices of a tensor: dst[c*ldd+r]=src[r*lds+c]. The full sublength x sublength tiles go to
+ * the specialized kernel through the pointers of their rows, the others to a plain loop
+ * Input:
+ *      src (const float*) - Start of the matrix
+ *      lds (long) - Distance between two rows of src
+ *      dst (float*) - Start of the transposed matrix
+ *      ldd (long) - Distance between two rows of dst
+ *      rows, cols (int) - Dimensions of src
+ *      sublength (int) - Dimension of the submatrix, at most MAXIMUMSUBLENGTH
+ * Output: none
  */
-float** allocateMatrixPerMode(Mode mode, int n) {
-    float** M=NULL;
-    switch (mode) {
-        case SEQ: {
-            M=createFloatSquareMatrix(n);
-        }
-            break;
-        case IMP_STAND:
-        case IMP_REC:
-        case OMP_LOC_WS:
-        case OMP_GLB_WS:
-        case OMP_LOC_BB:
-        case OMP_GLB_BB:
-        //case OMP_LOC_TB:
-        //case OMP_GLB_TB:
-        {
-            //M=createFloatSquareMatrixAligned(n, sublength);
-            M=createFloatSquareMatrixAligned(n, MINIMUMSUBLENGTH);
+static void transposeStrided(const float* src, long lds, float* dst, long ldd, int rows, int cols, int sublength) {
+    const TileKernel kernel=getTileKernel(sublength);
+    float* m_rows[MAXIMUMSUBLENGTH];
+    float* t_rows[MAXIMUMSUBLENGTH];
+    for (int i=0; i<cols; i+=sublength) {
+        for (int j=0; j<rows; j+=sublength) {
+            const int k_min=MIN(cols, i+sublength);
+            const int l_min=MIN(rows, j+sublength);
+            if(kernel!=NULL && k_min-i==sublength && l_min-j==sublength) {
+                for (int k=0; k<sublength; k++) {
+                    m_rows[k]=(float*)src+(j+k)*lds+i;
+                    t_rows[k]=dst+(i+k)*ldd+j;
+                }
+                kernel(m_rows, t_rows, 0, 0, 0, 0);
+                continue;
+            }
+            for (int k=i; k<k_min; k++) {
+                #pragma omp simd
+                for (int l=j; l<l_min; l++) {
+                    dst[k*ldd+l]=src[l*lds+k];
+                }
+            }
         }
-        break;
-        case START:
-        case END:
-            exit(1);
-            break;
-        default:
-            exit(1);
-            break;
     }
-    return M;
 }
 /*
- *  Name: initializeMatrix
- *  Function that initializes a matrix based on test. Elements are populated with either random values, static values, or predefined values for symmetric or worst-case test scenarios.
- *  Input:
- *      M (float**) - The matrix to be initialized. This matrix will be filled with values based on the selected test type
- *      test (Test) - The test type that determines how the matrix will be initialized. It can be RANDOM, STATIC, SYM, or WORST (0, 1, 2, 3)
- *      n (int) - Size of Matrix
- *  Output: none
+ * Name: tensorPermute
+ * Permutation of the axes of a row-major tensor: axis k of dst is axis perm[k] of src (so NCHW -> NHWC
+ * is perm {0, 2, 3, 1}). First the problem is reduced: the axes of size 1 are dropped and the axes that
+ * stay adjacent and in the same order are merged (H, W become one axis). Then:
+ *      - no axis moved: a parallel copy
+ *      - the innermost axis doesn't move: copies of contiguous rows, in parallel on the outer axes
+ *      - otherwise: a batch of 2D transpositions between the innermost axis of src and the one that
+ *        becomes innermost in dst, done with the block kernels (transposeStrided) and in parallel on the
+ *        outer axes and on the bands of sublength columns
+ * Input:
+ *      src (const float*) - The tensor
+ *      dst (float*) - The permuted tensor (same number of elements, not overlapped with src)
+ *      ndim (int) - Number of axes (1 to TENSORMAXDIMS)
+ *      shape (const long*) - Dimensions of src
+ *      perm (const int*) - Permutation of 0..ndim-1
+ *      sublength (int) - Dimension of the submatrix, at most MAXIMUMSUBLENGTH
+ * Output: none
  */
-void initializeMatrix(float** M, Test test, int n) {
-    if(test==STATIC) {
-        srand(38);
+void tensorPermute (const float* src, float* dst, int ndim, const long* shape, const int* perm, int sublength) {
+    if(ndim<1 || ndim>TENSORMAXDIMS || sublength<1 || sublength>MAXIMUMSUBLENGTH) {
+        fprintf(stderr, "Error, the tensor has to have between 1 and %d axes and the submatrix at most %d\n", TENSORMAXDIMS, MAXIMUMSUBLENGTH);
+        exit(1);
     }
-    else {
-        if (test==RANDOM) {
-            srand((unsigned)time(NULL));
+    bool seen[TENSORMAXDIMS]={false};
+    long total=1;
+    for (int k=0; k<ndim; k++) {
+        if(perm[k]<0 || perm[k]>=ndim || seen[perm[k]] || shape[k]<1) {
+            fprintf(stderr, "Error, invalid shape or permutation of the axes\n");
+            exit(1);
         }
+        seen[perm[k]]=true;
+        total*=shape[k];
     }
-    for (int i=0; i<n; i++) {
-        for (int j=0; j<n; j++) {
-            switch (test) {
-                case RANDOM: M[i][j]=random_float2(0, 9999); break;
-                case STATIC:
-                    M[i][j]=random_float2(0, 9999); break;
-                    //M[i][j]=i*1.0/200000*n+j*1.0/100+1; break;
-                case SYM:
-                case WORST: M[i][j]=5.0; break;
-                default: fprintf(stderr, "Unexpected Error\n"); exit(1);
-            }
+    //Axes of size 1 dropped
+    int index[TENSORMAXDIMS];
+    long dims[TENSORMAXDIMS];
+    int n=0;
+    for (int k=0; k<ndim; k++) {
+        index[k]=(shape[k]>1) ? n : -1;
+        if(shape[k]>1) {
+            dims[n++]=shape[k];
         }
     }
-    if(test==WORST) {
-        M[n-2][n-1]=3.0;
+    int order[TENSORMAXDIMS];
+    int m=0;
+    for (int k=0; k<ndim; k++) {
+        if(index[perm[k]]>=0) {
+            order[m++]=index[perm[k]];
+        }
     }
-}
-/*
- *  Name: executionProgram
- *  Function that handles matrix transposition based on the selected mode. The function checks if matrix meets the requirements for the selected mode (symmetry), and if not, it performs the necessary matrix transposition
- *  Input:
- *      M (float**) - The matrix that has to be transposed
- *      T (float**) - Destination Matrix
- *      mode (Mode) - The execution mode that determines the type of transposition and the parallelism
- *      n (int) - Size of Matrix
- *      sublength (int) - The sublength used in some parallelism modes for block-based transposition.
- *  Output: bool - Returns `true` if the matrix was already valid. Returns `false` if a transposition was required and performed.
- */
-bool executionProgram(float** M, float** T, Mode mode, int n, int sublength) {
-    switch (mode) {
-        case SEQ: {
-            if(!checkSym(M, n)) {
-                matTranspose(M, T, n);
-                return false;
-            }
+    //Groups of axes adjacent in src and in dst, in the order of dst
+    int first[TENSORMAXDIMS], groups=0;
+    long size[TENSORMAXDIMS];
+    for (int p=0; p<m; p++) {
+        if(groups>0 && order[p]==order[p-1]+1) {
+            size[groups-1]*=dims[order[p]];
         }
-        break;
-        case IMP_STAND: {
-            if(!checkSymImpStandard(M, n, sublength)) {
-                matTransposeImpStandard(M, T, n, sublength);
-                return false;
-            }
+        else {
+            first[groups]=order[p];
+            size[groups]=dims[order[p]];
+            groups++;
         }
-        break;
-        case IMP_REC: {
-            if(!checkSymImpRecursive(M, 0, n, 0, n, sublength)) {
-                matTransposeImpRecursive(M, T, 0, n, 0, n, sublength);
-                return false;
-            }
+    }
+    //P[g]: axis of src of the g-th axis of dst, after merging (the groups ranked by their first axis)
+    int P[TENSORMAXDIMS];
+    long S[TENSORMAXDIMS];
+    for (int g=0; g<groups; g++) {
+        P[g]=0;
+        for (int h=0; h<groups; h++) {
+            P[g]+=(first[h]<first[g]);
         }
-        break;
-        // OMP variables can be seen via OMP_DISPLAY_ENV=TRUE
-        //In order to optimize it we use the following environment variables:
-        /*
-         * export OMP_NUM_THREADS=8          //Threads executing
-         * export OMP_SCHEDULE=static    //Dynamic schedule
-         * export OMP_PROC_BIND=TRUE         //Bind threads for cache locality
-         * export OMP_PLACES=cores           //Thread placement strategy
-         * export OMP_STACKSIZE=128M         //Maximum Matrix Dimension*2
-         * export OMP_WAIT_POLICY=ACTIVE     //Reduce thread idle time
-         * export OMP_NESTED=TRUE            //Enable nested parallelism for tasks
-         * export OMP_MAX_ACTIVE_LEVELS=OMP_NUM_THREADS    //Allow two levels of parallelism
-         * export OMP_CANCELLATION=TRUE      // Allow task cancellation
-         */
-        // WORK SHARING
-        case OMP_LOC_WS: {
-            #ifdef _OPENMP
-            if(!checkSymOMPLocal(M, n)) {
-                matTransposeOMPWorkSharing(M, T, n);
-                return false;
-            }
-            #endif
+        S[P[g]]=size[g];
+    }
+    if(groups<=1) {
+        #pragma omp parallel for schedule(static)
+        for (long i=0; i<total; i+=CACHELINE*KB) {
+            memcpy(dst+i, src+i, sizeof(float)*MIN(CACHELINE*KB, total-i));
         }
-        break;
-        case OMP_GLB_WS: {
-            #ifdef _OPENMP
-            if(!checkSymOMPGlobal(M, n)) {
-                matTransposeOMPWorkSharing(M, T, n);
-                return false;
+        return;
+    }
+    long src_stride[TENSORMAXDIMS], dst_stride[TENSORMAXDIMS];
+    src_stride[groups-1]=1;
+    for (int k=groups-2; k>=0; k--) {
+        src_stride[k]=src_stride[k+1]*S[k+1];
+    }
+    long stride=1;
+    for (int g=groups-1; g>=0; g--) {
+        dst_stride[P[g]]=stride;
+        stride*=S[P[g]];
+    }
+    const int inner=groups-1;
+    if(P[groups-1]==inner) {
+        //Rows of S[inner] contiguous in both, the outer index is the one of dst
+        const long rows=total/S[inner];
+        #pragma omp parallel for schedule(static)
+        for (long r=0; r<rows; r++) {
+            long rest=r, offset=0;
+            for (int g=groups-2; g>=0; g--) {
+                offset+=(rest%S[P[g]])*src_stride[P[g]];
+                rest/=S[P[g]];
             }
-            #endif
+            memcpy(dst+r*S[inner], src+offset, sizeof(float)*S[inner]);
         }
-        break;
-        //FOR BLOCK BASED HAVE SIMD -O3 -march=native -ffast-math -funroll-loops
-        // -fopenmp -fopenmp-simd
-        // • export OMP_PROC_BIND=true
-        // • export OMP_PLACES=cores
-        // • OMP_DYNAMIC=TRUE
-        case OMP_LOC_BB: {
-            #ifdef _OPENMP
-            if(!checkSymOMPLocal(M, n)) {
-                matTransposeOMPBlockingBased(M, T, n, sublength);
-                return false;
-            }
-            #endif
+        return;
+    }
+    //2D transpositions between axis a (innermost of dst) and the innermost of src, the others are the batch
+    const int a=P[groups-1];
+    int outer_axes[TENSORMAXDIMS], outers=0;
+    for (int k=0; k<inner; k++) {
+        if(k!=a) {
+            outer_axes[outers++]=k;
         }
-        break;
-        case OMP_GLB_BB: {
-            #ifdef _OPENMP
-            if(!checkSymOMPGlobal(M, n)) {
-                matTransposeOMPBlockingBased(M, T, n, sublength);
-                return false;
-            }
-            #endif
+    }
+    const long batch=total/(S[a]*S[inner]);
+    const long bands=(S[inner]+sublength-1)/sublength;
+    #pragma omp parallel for schedule(static)
+    for (long unit=0; unit<batch*bands; unit++) {
+        long rest=unit/bands, src_offset=0, dst_offset=0;
+        for (int o=outers-1; o>=0; o--) {
+            const int k=outer_axes[o];
+            src_offset+=(rest%S[k])*src_stride[k];
+            dst_offset+=(rest%S[k])*dst_stride[k];
+            rest/=S[k];
         }
-        break;
-        //FOR TASK BASED WE ACTIVATE compile -O3 -march=native
-        // • export OMP_DYNAMIC=TRUE
-        // • export OMP_NESTED=TRUE
-        // • export OMP_MAX_ACTIVE_LEVELS=2
-        // • export OMP_PROC_BIND=spread
-        /*case OMP_LOC_TB: {
-            #ifdef _OPENMP
-            omp_set_nested(1);
-            if(!checkSymOMPLocal(M, n)) {
-                #pragma omp parallel
-                {
-                    #pragma omp single
-                    {
-                        matTransposeOMPTaskBased(M, T, 0, n, 0, n, sublength);
-                    }*/
-                    /*int start=(n/(omp_get_num_threads()*2))*omp_get_thread_num();
-                    int end=(n/(omp_get_num_threads()*2))*(omp_get_thread_num()+1);
-                    matTransposeOMPTaskBased(M, T, start, end, start, end, sublength);
-                }
-                return false;
-            }
-            #endif
+        const long c=(unit%bands)*sublength;
+        transposeStrided(src+src_offset+c, src_stride[a], dst+dst_offset+c*dst_stride[inner], dst_stride[inner], (int)S[a], (int)MIN(sublength, S[inner]-c), sublength);
+    }
+}
+/*
+ * Name: PrintMatrix
+ * Prints out on stdout all the Matrix indexed. This was used for control to verify that the program worked for small matrices. It's not present in the running code
+ *   Input:
+ *      M (float**) - The start allocated in heap matrix
+ *      size(int) - Dimension of the matrix
+ * Output: none
+ */
+void printMatrix(float** M, int size) {
+    for (int i=0; i<size; i++) {
+        for(int j=0; j<size; j++) {
+            printf("%.2f\t", M[i][j]);
         }
-        break;*/
-        /*case OMP_GLB_TB: {
-            #ifdef _OPENMP
-            if(!checkSymOMPGlobal(M, n)) {
-                #pragma omp parallel
-                {
-                    #pragma omp single
-                    matTransposeOMPTaskBased(M, T, 0, n, 0, n, sublength);*/
-                   /* int start=(n/(omp_get_num_threads()*2))*omp_get_thread_num();
-                    int end=(n/(omp_get_num_threads()*2))*(omp_get_thread_num()+1);
-                    matTransposeOMPTaskBased(M, T, start, end, start, end, sublength);
+        printf("\n");
+    }
+}
+/*
+ * Name: control
+ * Another control algorithm for verifying that the transposition happened correctly. Happened a transposition of
+ *   Input:
+ *      M (float**) - The start allocated in heap matrix
+ *      T (float**) - The destination allocated in heap matrix
+ *      size(int) - Dimension of the matrix
+ * Output: none
+ */
+void control(float** M, float** T, int N) {
+    printf("[%d][%d] M: %.2f T: %.2f\n", 1, 2, M[1][2], T[2][1]);
+    printf("[%d][%d] M: %.2f T: %.2f\n", N/2-4, N/2+2, M[N/2-4][N/2+2], T[N/2+2][N/2-4]);
+    printf("[%d][%d] M: %.2f T: %.2f\n", N-5, N-3, M[N-5][N-3], T[N-3][N-5]);
+}
+/*
+ * Name: verifyTranspose
+ * Exhaustive control that T is the transposed of M: the blocks of T are compared in parallel with the mirrored
+ * ones of M, each block with a simd reduction of the differences. It only reads, with the same blocks
+ * of the transposition, so it costs less than a transposition. A NaN is always a difference
+ *   Input:
+ *      M (float**) - The start matrix (rows x cols)
+ *      T (float**) - The matrix to control (cols x rows), it can be M itself to control a symmetric one
+ *      rows, cols (int) - Dimensions of M
+ *      tolerance (float) - Maximum difference accepted (0 for the exact copy)
+ *      sublength (int) - Dimension of the submatrix
+ * Output: long - Number of elements different
+ */
+long verifyTranspose(float** M, float** T, int rows, int cols, float tolerance, int sublength) {
+    long errors=0;
+    #pragma omp parallel for collapse(2) schedule(static) reduction(+:errors)
+    for (int i=0; i<cols; i+=sublength) {
+        for (int j=0; j<rows; j+=sublength) {
+            const int k_min=MIN(cols, i+sublength);
+            const int l_min=MIN(rows, j+sublength);
+            int local=0;
+            for (int k=i; k<k_min; k++) {
+                const float* t=T[k];
+                #pragma omp simd reduction(+:local)
+                for (int l=j; l<l_min; l++) {
+                    local+=!(ABS_DIFF(t[l], M[l][k])<=tolerance);
                 }
-                return false;
             }
-            #endif
+            errors+=local;
         }
-        break;*/
-        default:
-            exit(1);
-            break;
     }
-    freeMemory(T, n);
-    T=M;
-    return true;
+    return errors;
 }
 /*
- *  Name: openFilesAvgPerMode
- *  Function that opens specific files based on the mode and writes the average time for a particular mode of matrix operation in a particular file
- *  Input:
- *      code (const char*) - A string representing the code identifier
- *      mode (const int) - The execution mode that determines which file will be opened and written to
- *      n (const int) - The dimension of the matrix (number of rows/columns)
- *      test (const int) - Test for data in matrix
- *      samples (const int) - The number of samples.
- *      num_threads (const int) - The number of threads
- *      avg_time (const double) - The average time taken
+ * Name: fmix32
+ * Finalizer of MurmurHash3: a bijection of 32 bits that spreads each bit on all the others. It has only 32 bits
+ * multiplications, so it's vectorized also with AVX2 (splitmix64 needs AVX-512 for the 64 bits ones)
  */
-void openFilesAvgPerMode(const char* code, const int mode, const int n, const int test, const int samples, const int num_threads, const double avg_time) {
-    openFile(FILENAMEGEN, code, mode, n, test, samples, num_threads, avg_time, 1);
-    switch (mode) {
-        case SEQ:
-            openFile(FILENAMESEQ, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;
-        case IMP_STAND:
-            openFile(FILENAMEIMPSTAND, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;
-        case IMP_REC:
-            openFile(FILENAMEIMPREC, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;
-        case OMP_LOC_WS:
-            openFile(FILENAMEOMPLOCWS, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;
-        case OMP_GLB_WS:
-            openFile(FILENAMEOMPGLBWS, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;
-        case OMP_LOC_BB:
-            openFile(FILENAMEOMPLOCBB, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;
-        case OMP_GLB_BB:
-            openFile(FILENAMEOMPGLBBB, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;
-        /*case OMP_LOC_TB:
-            openFile(FILENAMEOMPLOCTB, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;
-        case OMP_GLB_TB:
-            openFile(FILENAMEOMPGLBTB, code, mode, n, test, samples, num_threads, avg_time, 1);
-            break;*/
-        default:
+static inline uint32_t fmix32(uint32_t x) {
+    x^=x>>16;
+    x*=0x85EBCA6BU;
+    x^=x>>13;
+    x*=0xC2B2AE35U;
+    return x^(x>>16);
+}
+/*
+ * Name: checksumMatrix
+ * Checksum independent from the order of the elements: the sum (modulo 2^64) of a hash of each element with its
+ * position, so M and T are read row by row in parallel at the speed of the memory. With transposed the element
+ * [i][j] is taken as [j][i], so the checksum of T transposed is the one of M only if T is its transposed (up to
+ * a collision of the hash). It compares the bits, so 0 and -0 are different
+ *   Input:
+ *      M (float**) - The matrix
+ *      rows, cols (int) - Dimensions of M
+ *      transposed (bool) - Positions exchanged
+ * Output: uint64_t - The checksum
+ */
+uint64_t checksumMatrix(float** M, int rows, int cols, bool transposed) {
+    uint64_t sum=0;
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (int i=0; i<rows; i++) {
+        const float* row=M[i];
+        //Index in M, row-major (unique up to 2^32 elements), of the element j of the row and step to the next one
+        const uint32_t first=transposed ? (uint32_t)i : (uint32_t)i*cols;
+        const uint32_t step=transposed ? (uint32_t)rows : 1;
+        //Sum of the row apart, the simd reduction on the one privatized by the parallel for isn't vectorized
+        uint64_t local=0;
+        #pragma omp simd reduction(+:local)
+        for (int j=0; j<cols; j++) {
+            uint32_t bits;
+            memcpy(&bits, &row[j], sizeof(bits));
+            local+=fmix32(bits^((first+(uint32_t)j*step)*0x9E3779B1U));
+        }
+        sum+=local;
+    }
+    return sum;
+}
+/*
+ *  Name: getVerifyMode
+ *  Verification of each result, from TRANSPOSE_VERIFY (read only once):
+ *      not set - no verification
+ *      full - verifyTranspose on all the elements
+ *      checksum - checksumMatrix of M and T, verifyTranspose only if they are different, to count the errors
+ *  Output: VerifyMode - The chosen mode
+ */
+VerifyMode getVerifyMode(void) {
+    static int mode=-1;
+    if(mode<0) {
+        const char* value=getenv(VERIFYVARIABLE);
+        mode=VERIFY_OFF;
+        if(value!=NULL && strcmp(value, "full")==0) {
+            mode=VERIFY_FULL;
+        }
+        else if(value!=NULL && strcmp(value, "checksum")==0) {
+            mode=VERIFY_CHECKSUM;
+        }
+        else if(value!=NULL && value[0]!='\0' && strcmp(value, "off")!=0) {
+            fprintf(stderr, "Unknown %s=%s, it has to be full, checksum or off\n", VERIFYVARIABLE, value);
             exit(1);
-            break;
+        }
     }
+    return mode;
 }
 /*
- *  Name: openFilesResultsPerMode
- *  Function that opens specific result files based on the mode and writes the execution time for a particular mode of matrix operation.
+ *  Name: verifyExecution
+ *  Verifies the result of executionProgram as getVerifyMode says, it has to be called outside of the measure. If M was
+ *  found symmetric T wasn't written, so it is M that is compared with its transposed, with the tolerance of the check
  *  Input:
- *      code (const char*) - A string representing the code identifier
- *      mode (const int) - The execution mode that determines which file will be opened and written to
- *      n (const int) - The dimension of the matrix (number of rows/columns)
- *      test (const int) - The test type used for matrix generation.
- *      samples (const int) - The number of samples for benchmarking.
- *      num_threads (const int) - The number of threads used in parallelism
- *      time (const double) - The execution time taken for the operation
+ *      M (float**) - The start matrix
+ *      T (float**) - The transposed one (not used if symmetric)
+ *      n (int) - Dimension of the matrix
+ *      symmetric (bool) - Result of executionProgram
+ *      sublength (int) - Dimension of the submatrix
+ *  Output: long - Number of elements wrong (0 also without verification)
  */
-void openFilesResultsPerMode(const char* code, const int mode, const int n, const int test, const int samples, const int num_threads, const double time) {
-    openFile(FILENAMETGEN, code, mode, n, test, samples, num_threads, time, 0);
-    switch (mode) {
-        case SEQ:
-            openFile(FILENAMETSEQ, code, mode, n, test, samples, num_threads, time, 0);
-            break;
-        case IMP_STAND:
-            openFile(FILENAMETIMPSTAND, code, mode, n, test, samples, num_threads, time, 0);
-            break;
-        case IMP_REC:
-            openFile(FILENAMETIMPREC, code, mode, n, test, samples, num_threads, time, 0);
-            break;
-        case OMP_LOC_WS:
-            openFile(FILENAMETOMPLOCWS, code, mode, n, test, samples, num_threads, time, 0);
-            break;
-        case OMP_GLB_WS:
-            openFile(FILENAMETOMPGLBWS, code, mode, n, test, samples, num_threads, time, 0);
-            break;
-        case OMP_LOC_BB:
-            openFile(FILENAMETOMPLOCBB, code, mode, n, test, samples, num_threads, time, 0);
-            break;
-        case OMP_GLB_BB:
-            openFile(FILENAMETOMPGLBBB, code, mode, n, test, samples, num_threads, time, 0);
-            break;
-        /*case OMP_LOC_TB:
-            openFile(FILENAMETOMPLOCTB, code, mode, n, test, samples, num_threads, time, 0);
-            break;
-        case OMP_GLB_TB:
-            openFile(FILENAMETOMPGLBTB, code, mode, n, test, samples, num_threads, time, 0);
-            break;*/
-        default:
-            exit(1);
-            break;
+long verifyExecution(float** M, float** T, int n, bool symmetric, int sublength) {
+    const VerifyMode mode=getVerifyMode();
+    if(mode==VERIFY_OFF) {
+        return 0;
+    }
+    if(symmetric) {
+        return verifyTranspose(M, M, n, n, ERROR, sublength);
+    }
+    if(mode==VERIFY_CHECKSUM && checksumMatrix(M, n, n, false)==checksumMatrix(T, n, n, true)) {
+        return 0;
     }
+    return verifyTranspose(M, T, n, n, 0.0f, sublength);
 }
+//Floats of the private part of each thread and of the shared part of clearAllCache
+#define SWEEPPRIVATE ((CACHESIZEL1D+CACHESIZEL2)/sizeof(float))
+#define SWEEPSHARED (CACHESIZEL3/sizeof(float))
+typedef struct {
+    float* sweep;
+    int threads;    //private parts allocated
+    int team;       //threads of this sweep, one tile each
+} SweepJob;
 /*
- * Name: bubblesort
- * Reorder an Array in ascending order
+ *  Name: sweepTile
+ *  Tile of clearAllCache: the thread writes its private part and the tile-th slice of the shared part
  */
-void bubbleSort(double* a, int size) {
-    for (int i=0; i<(size-1); i++) {
+static void sweepTile(long tile, int thread, void* arg) {
+    SweepJob* job=arg;
+    float* mine=job->sweep+SWEEPPRIVATE*thread;
+    for (size_t i=0; i<SWEEPPRIVATE; i++) {
+        mine[i]=1.0f;
+    }
+    float* shared=job->sweep+SWEEPPRIVATE*job->threads;
+    const size_t first=SWEEPSHARED*tile/job->team;
+    const size_t last=SWEEPSHARED*(tile+1)/job->team;
+    for (size_t i=first; i<last; i++) {
+        shared[i]=1.0f;
+    }
+}
+/*
+ *  Name: clearCache
+ *  Function that tries to free memory for the various chunk of memory in order to minimize the number of more efficient simulation. This isn't guarantee to always work, but it brought less outliers.
+ *  Now it's an eviction sweep done in parallel by the threads of the mode (pinned by threadInit, see runRows): each thread writes
+ *  a private buffer as big as its L1d and L2, so the private caches of all the cores used by the mode are
+ *  evicted and not only the ones of the calling thread, and the L3 part is split between the threads.
+ *  The buffer is allocated (and touched) only the first time, so the next sweeps cost only the writes
+ *  Input: none
+ *  Output: none
+ */
+void clearAllCache(void) {
+    static float* sweep=NULL;
+    static int threads=0;
+    const int team=getRowsThreads();
+    if(sweep==NULL || team>threads) {
+        free(sweep);
+        if(posix_memalign((void**)&sweep, CACHELINE, sizeof(float)*(SWEEPPRIVATE*team+SWEEPSHARED)) != 0) {
+            fprintf(stderr, "Failed to allocate aligned memory\n");
+            exit(1);
+        }
+        threads=team;
+    }
+    SweepJob job={.sweep=sweep, .threads=threads, .team=team};
+    runRows(team, sweepTile, &job);
+}
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ *  Name: flushRow
+ *  Tile of flushMatrix: the lines of a row
+ */
+static void flushRow(long i, int thread, void* arg) {
+    (void)thread;
+    RowsJob* job=arg;
+    const char* line=(const char*)job->M[i];
+    for (size_t k=0; k<sizeof(float)*job->cols; k+=CACHELINE) {
+        #ifdef __CLFLUSHOPT__
+            _mm_clflushopt((void*)(line+k));
+        #else
+            _mm_clflush(line+k);
+        #endif
+    }
+    //The last line if the row doesn't start at the beginning of a line
+    _mm_clflush((const char*)(job->M[i]+job->cols-1));
+}
+#endif
+/*
+ *  Name: flushMatrix
+ *  Removes the lines of a matrix from all the levels of cache of all the cores with clflushopt (clflush if
+ *  not compiled for a CPU that has it), rows split between the threads of the mode with runRows. Cheaper than a sweep, because
+ *  only the lines of the matrix are touched. On CPUs without these instructions it falls back to clearAllCache
+ *  Input:
+ *      M (float**) - The matrix
+ *      rows (int) - Number of rows
+ *      cols (int) - Number of columns
+ *  Output: none
+ */
+void flushMatrix(float** M, int rows, int cols) {
+    #if defined(__x86_64__) || defined(__i386__)
+    RowsJob job={.M=M, .rows=rows, .cols=cols};
+    runRows(rows, flushRow, &job);
+    _mm_mfence();
+    #else
+    (void)M;
+    (void)rows;
+    (void)cols;
+    clearAllCache();
+    #endif
+}
+/*
+ *  Name: warmRow
+ *  Tile of warmMatrix: reads a row
+ */
+static void warmRow(long i, int thread, void* arg) {
+    (void)thread;
+    RowsJob* job=arg;
+    float sum=0.0f;
+    for (int j=0; j<job->cols; j++) {
+        sum+=job->M[i][j];
+    }
+    //Keeps the reads
+    volatile float sink=sum;
+    (void)sink;
+}
+/*
+ *  Name: warmMatrix
+ *  Reads all the matrix with the rows split between the threads of the mode with runRows, so each thread
+ *  has in its caches the part it will work on (as far as it fits)
+ *  Input:
+ *      M (float**) - The matrix
+ *      rows (int) - Number of rows
+ *      cols (int) - Number of columns
+ *  Output: none
+ */
+void warmMatrix(float** M, int rows, int cols) {
+    RowsJob job={.M=M, .rows=rows, .cols=cols};
+    runRows(rows, warmRow, &job);
+}
+/*
+ *  Name: getCacheState
+ *  State of the caches to have before each measure, from TRANSPOSE_CACHE (read only once):
+ *      cold (default) - eviction sweep with clearAllCache
+ *      flush - the lines of M and T are flushed with flushMatrix
+ *      warm - M and T are read just before the measure
+ *  Output: CacheState - The chosen state
+ */
+CacheState getCacheState(void) {
+    static int state=-1;
+    if(state<0) {
+        const char* value=getenv(CACHEVARIABLE);
+        state=CACHE_COLD;
+        if(value!=NULL && strcmp(value, "flush")==0) {
+            state=CACHE_FLUSH;
+        }
+        else if(value!=NULL && strcmp(value, "warm")==0) {
+            state=CACHE_WARM;
+        }
+        else if(value!=NULL && strcmp(value, "cold")!=0) {
+            fprintf(stderr, "Unknown %s=%s, it has to be cold, flush or warm\n", CACHEVARIABLE, value);
+            exit(1);
+        }
+    }
+    return state;
+}
+/*
+ *  Name: prepareCache
+ *  Puts the caches in the state of getCacheState, it has to be called after the initialization of M
+ *  (that loads M in cache) and just before the measure
+ *  Input:
+ *      M (float**) - The start matrix
+ *      T (float**) - The destination matrix (NULL if it's allocated later by executionProgram, only M is prepared)
+ *      n (int) - Size of the matrices
+ *  Output: none
+ */
+void prepareCache(float** M, float** T, int n) {
+    switch (getCacheState()) {
+        case CACHE_FLUSH:
+            flushMatrix(M, n, n);
+            if(T!=NULL) {
+                flushMatrix(T, n, n);
+            }
+            break;
+        case CACHE_WARM:
+            warmMatrix(M, n, n);
+            if(T!=NULL) {
+                warmMatrix(T, n, n);
+            }
+            break;
+        default:
+            clearAllCache();
+            break;
+    }
+}
+/*
+ *  Name: eagerDestination
+ *  Allocation of the destination of the executable, from TRANSPOSE_DESTINATION (read only once):
+ *      lazy (default) - executionProgram allocates T only if M isn't symmetric, inside the measure
+ *      eager - T is allocated and put in the state of getCacheState before the measure, as in Final Results
+ *  Output: bool - true with eager
+ */
+bool eagerDestination(void) {
+    static int eager=-1;
+    if(eager<0) {
+        const char* value=getenv(DESTINATIONVARIABLE);
+        eager=0;
+        if(value!=NULL && strcmp(value, "eager")==0) {
+            eager=1;
+        }
+        else if(value!=NULL && strcmp(value, "lazy")!=0) {
+            fprintf(stderr, "Unknown %s=%s, it has to be lazy or eager\n", DESTINATIONVARIABLE, value);
+            exit(1);
+        }
+    }
+    return eager;
+}
+/*
+ *  Name: getSequential
+ *  Function that retrieves the sequential execution time for a given dimension and test from a file.
+ *  Input:
+ *      dim (int) - Dimension for which we are retrieving the sequential time
+ *      test (int) - Test identifier to filter the relevant entry
+ *  Output:
+ *      double - Returns the average time for the sequential execution. If not found in the file, it returns 0.00
+ */
+double getSequential(const int dim, const int test) {
+    char line[256];
+    int findex, fmode, fdimension, ftest, fsamples, fthreads;
+    char fcompile[20];
+    double favg_time=0.0, fseq_time, fspeedup, fefficiency;
+    FILE* file=fopen(FILENAMESEQ, "a+");
+    if(file==NULL) {
+        fprintf(stderr, "Couldn't open or create file %s\n", FILENAMESEQ);
+        exit(1);
+    }
+    bool found=false;
+    fgets(line, sizeof(line), file);
+    while(!found && (fscanf(file, "%d %10s %d %d %d %d %d %lf %lf %lf %lf%%", &findex, fcompile, &fmode, &fdimension, &ftest,
+          &fsamples, &fthreads, &favg_time, &fseq_time,
+          &fspeedup, &fefficiency)==11)) {
+        if(fmode==1 && (strcmp(fcompile, "SO0")==0) && fdimension==dim && ftest==test) {
+            found=true;
+        }
+    }
+    fclose(file);
+    if(found) {
+        return favg_time;
+    }
+    else {
+        return 0.00;
+       /* clearAllCache();
+        char command[256];
+        //snprintf(command, sizeof(command), "gcc -O0 functions.c transpose.c -o transpose -lm");
+       // executeCommand(command);
+        float get_integer=(log(dim)/log(2));
+        snprintf(command, sizeof(command), "taskset -c 0 ./transpose SO0 1 %d %d %d", (int)get_integer, test, samples);
+        executeCommand(command);
+        return getSequential(dim, test, samples);*/
+    }
+}
+/* NO MORE USED NOT MORE USEFUL
+ *  Name: executeCommand
+ *  Function that executes a given command in the system shell. If the command fails (i.e., returns a non-zero value), it reports an error and exits the program.
+ *  Input:
+ *      command (char[]) - The command to be executed as a string
+ *  Output: none
+ *      Exits the program if the command execution fails.
+ NO MORE USED NOT MORE USEFUL
+ */
+void executeCommand(char command[]) {
+    int result=system(command);
+    if (result != 0) {
+       fprintf(stderr, "Error executing ./transpose command\n");
+       exit(1);
+   }
+}
+/*
+ *  Name: openFile
+ *  Function that opens a file and appends performance data. Depending on the mode and type, it computes speedup and efficiency, then writes on the file the input parameters and calculated information. Writes performance data to the file. If the file is empty, it writes a header before appending data.
+ *  Input:
+ *      filename (const char*) - The name of the file to open.
+ *      code (const char*) - The code or label to be recorded in the file
+ *      mode (int) - The mode of the computation (SO0 for sequential - see readMe for others)
+ *      dim (int) - Dimension Size
+ *      test (int) - The test case identifier
+ *      samples (int) - The number of samples
+ *      num_threads (int) - The number of threads used
+ *      avg_time (double) - The average time taken for the computation
+ *      type (int) - Determines the type of output file (0 - times, 1- average)
+ *  Output: none
+ */
+void openFile(const char* filename, const char* code, const int mode, const int dim, const int test, const int samples, const int num_threads, double avg_time, int type) {
+    FILE* file=fopen(filename, "a+"); //read and append
+    if(file==NULL) {
+        fprintf(stderr, "Couldn't open or create %s\n", filename);
+        exit(1);
+    }
+    //int lines=countFile(file);
+    FILE* wc=NULL;
+    if(type==1) {
+        wc=popen("wc -l < resultsGeneral.csv", "r");
+    }
+    else{
+        if (type==0) {
+            wc=popen("wc -l < timesGeneral.csv", "r");
+        }
+    }
+    if (wc==NULL) {
+        fprintf(stderr, "Error running wc -l\n");
+        fclose(file);
+        exit(1);
+    }
+    int lines;
+    fscanf(wc, "%d", &lines);
+    fclose(wc);
+    if(lines==0){
+        lines=1;
+    }
+    double seq_time = 0.0;
+    double speedup=0.0;
+    double efficiency=0.0;
+    if(mode!=SEQ && type==1) {
+        fclose(file);
+        seq_time=getSequential(dim, test);
+        file=fopen(filename, "a+"); //read and append
+        if(file==NULL) {
+            fprintf(stderr, "Couldn't open or create %s\n", filename);
+            exit(1);
+        }
+        speedup=seq_time/avg_time;
+        efficiency=speedup/num_threads*100;
+    }
+    else {
+        seq_time=avg_time;
+        speedup=seq_time/avg_time;
+        efficiency=speedup/num_threads*100;
+    }
+    fseek(file, 0, SEEK_END);
+    long long file_size=ftell(file);
+    if(file_size==0 && type==1) {
+        fprintf(file, "%-10s %-10s %-5s %-10s %-10s %-10s %-10s %-15s %-15s %-10s %-10s\n", "N°", "Compile", "Mode", "Dimension", "Test_Mode", "Samples", "Threads", "Avg_Time(s)", "Seq_time(s)", "Speedup", "Efficiency");
+    }
+    else {
+        if(file_size==0 && type==0) {
+            fprintf(file, "%-10s %-10s %-5s %-10s %-10s %-10s %-10s %-15s\n", "N°", "Compile", "Mode", "Dimension", "Test_Mode", "Samples", "Threads", "Time(s)");
+        }
+    }
+    char void_element='-';
+    if(type==0) {
+        fprintf(file, "%-10d %-10s %-5d %-10d %-10d %-10d %-10d %-15.12lf\n", lines, code, mode, dim, test, samples, num_threads, avg_time);
+    }
+    else {
+        if(seq_time<1e-9) {
+            fprintf(file, "%-10d %-10s %-5d %-10d %-10d %-10d %-10d %-15.12f %-15c %-10c %-10c%%\n", lines, code, mode, dim, test, samples, num_threads, avg_time, void_element, void_element, void_element);
+        }
+        else {
+            fprintf(file, "%-10d %-10s %-5d %-10d %-10d %-10d %-10d %-15.12lf %-15.12lf %-10.2lf %-10.2lf%%\n", lines, code, mode, dim, test, samples, num_threads, avg_time, seq_time, speedup, efficiency);
+        }
+    }
+    fclose(file);
+}
+/*
+ *  Name: inputParameters
+ *  Function that checks the number of arguments passed to the program (6 or 7 ok, less exits.
+ *  Input:
+ *      argc (int) - The number of arguments passed to the program.
+ *  Output: none
+ */
+void inputParameters(int argc) {
+    if(argc!=6 && argc!=7) {
+        fprintf(stderr, "Invalid parameters. They are:\n\n(1) Code identifying the compilation (everything is acceptable, default one is SO0, is used as reference for sequential code -O0 and will be used as comparison for speedup and efficiency)\n\n(2)Integer for mode. The modes are:\n" MODESDESCRIPTION "\n(3) Exponential of 2 from 4 to 12 (16->4, 64->6, 1024->10, 4096->12)\n\n(4) Testing:\n0. Matrix is generated randomly\n1. A default test matrix is generated according to an algorithm (used for testing, with one interaction in checkSym and Transposition)\n2. A default test symmetric matrix (only checkSym works)\n3. The worst case scenario with a matrix, with only one element different not on main diagonal\n\n(5) Number of samples (>=25)\n\n(6) Number of Threads - If selected modes from 1 to 3 is not required, it will be ignored, but if are the others (OMP) it is important.\n\n");
+        exit(1);
+    }
+}
+/*
+ *  Name: valueInputed
+ *  Function that processes and validates the input values based on the argument provided. It checks if the input values are within valid ranges for different parameters (mode, dimension, test, samples, and number of threads). If any value is invalid, it prints an error message and exits the program.
+ *  Input:
+ *      argc (int) - The number of command-line arguments passed to the program
+ *      argv (const char*) - A string representing the argument value to be process
+ *      value (int) - The specific value identifying which input parameter is being validated (2. mode, 3. dimension, 4. test, 5. samples, 6. n° threads)
+ *  Output:
+ *      returnValue (int) - The validated integer value for the corresponding parameter
+ */
+int valueInputed(int argc, const char* argv, int value) {
+    int returnValue=-1;
+    if(value>=2 && value<=6) {
+        switch (value) {
+            case 2: {
+               returnValue=atoi(argv);
+                if (returnValue<=START || returnValue>=END) {
+                    fprintf(stderr, MODESDESCRIPTION "\n");
+                    exit(1);
+                }
+            }
+                break;
+            case 3: {
+                returnValue=pow(2, atoi(argv));
+                if (returnValue<MIN_SIZE || returnValue>MAX_SIZE) {
+                    fprintf(stderr, "Invalid dimension, it has to be a power of 2 between 4 and 12. Insert the exponential\n\n");
+                    exit(1);
+                }
+            }
+                break;
+            case 4: {
+                returnValue=atoi(argv);
+                if(returnValue>3 || returnValue<0) {
+                    fprintf(stderr, "Invalid testing, it has to be:\n\n0. (Random)\n1. (Standard Test No Symmetric)\n2. (Standard Test Symmetric)\n 3 (Worst Case Scenario)\n\n");
+                    exit(1);
+                }
+            }
+                break;
+            case 5: {
+                returnValue=atoi(argv);
+                if(returnValue<25) {
+                    fprintf(stderr, "Invalid samples number, it has to be at least of 25\n\n");
+                    exit(1);
+                }
+            }
+                break;
+            case 6: {
+                returnValue=atoi(argv);
+                if (returnValue<=0 && argc==7) {
+                    fprintf(stderr, "Invalid number of threads inserted, it has to be positive\n\n");
+                    exit(1);
+                }
+                else {
+                    if (argc!=7) {
+                        fprintf(stderr, "Invalid parameters. They are:\n\n(1) Code identifying the compilation (everything is acceptable, default one is SO0, is used as reference for sequential code -O0 and will be used as comparison for speedup and efficiency)\n\n(2)Integer for mode. The modes are:\n" MODESDESCRIPTION "\n(3) Exponential of 2 from 4 to 12 (16->4, 64->6, 1024->10, 4096->12)\n\n(4) Testing:\n0. Matrix is generated randomly\n1. A default test matrix is generated according to an algorithm (used for testing, with one interaction in checkSym and Transposition)\n2. A default test symmetric matrix (only checkSym works)\n3. The worst case scenario with a matrix, with only one element different not on main diagonal\n\n(5) Number of samples (>=25)\n\n(6) Number of Threads - If selected modes from 1 to 3 is not required, it will be ignored, but if are the others (OMP) it is important.\n\n");
+                        exit(1);
+                    }
+                }
+            }
+                break;
+            default:
+                exit(1);
+                break;
+        }
+    }
+    return returnValue;
+}
+/*
+ *  Name: threadInit
+ *  Function that initializes the number of threads based on the specified mode (if Sequential or Esplicit is 1 thread for the others it sets the number of threads accordingly to the inputed parameters)
+ *  Input:
+ *      argv (const char*) - Command-line argument value representing the number of threads
+ *      argc (int) - Number of command-line arguments
+ *      mode (int) - Mode specifying the type of execution (as described on readME)
+ *  Output:
+ *      NUM_THREADS (int) - The number of threads to be used for the parallel execution
+ */
+int threadInit(const char* argv, int argc, int mode) {
+    int NUM_THREADS=1;
+    if(mode==PTH_BB) {
+        NUM_THREADS=valueInputed(argc, argv, 6);
+    }
+    else if((mode>=OMP_LOC_WS && mode<=OMP_GLB_BB) || mode==SPARSE_CSR || mode==PIPE_BB || mode==HIER_BB) {
+        #ifdef _OPENMP
+            NUM_THREADS=valueInputed(argc, argv, 6);
+        #endif
+    }
+    return threadSetup(NUM_THREADS, mode);
+}
+/*
+ *  Name: threadSetup
+ *  Starts the threads of a mode with a number of threads already known (from threadInit or chooseAutoPlan): the
+ *  pool for the pthreads mode, the OMP team pinned for the OMP ones, a single pinned thread for the others
+ *  Input:
+ *      num_threads (int) - Number of threads (ignored in the sequential, implicit and MPI modes)
+ *      mode (int) - Mode specifying the type of execution (as described on readME)
+ *  Output:
+ *      NUM_THREADS (int) - The number of threads to be used for the parallel execution
+ */
+int threadSetup(int num_threads, int mode) {
+    int NUM_THREADS;
+    if(mode==MPI_BB) {
+        #if defined(USE_MPI) && defined(_OPENMP)
+            //Each rank is a worker, the threads inputed are ignored like in the implicit modes
+            MPI_Comm_size(MPI_COMM_WORLD, &NUM_THREADS);
+            omp_set_num_threads(1);
+            if(getRank()==0) {
+                printf("%d ranks\n\n", NUM_THREADS);
+            }
+        #else
+            fprintf(stderr,"Forgot mpicc -DUSE_MPI or -fopenmp flags for MODE=%d, please to run in this mode compile with them\n\n", mode);
+            exit(1);
+        #endif
+    }
+    else if(mode==PTH_BB) {
+        //It doesn't need -fopenmp: initialization, cache sweep and prefilter go on the pool too (see runRows)
+        NUM_THREADS=num_threads;
+        printf("%d\n", NUM_THREADS);
+        //The pool lives until the end of the program, so the threads are created only once
+        int* cpus=getPlacement(getenv(PLACESVARIABLE), NUM_THREADS);
+        defaultPool=threadPoolCreate(NUM_THREADS, cpus);
+        free(cpus);
+        #ifdef _OPENMP
+            //Only for what is outside the measure and still uses OMP (TRANSPOSE_VERIFY)
+            omp_set_num_threads(NUM_THREADS);
+        #endif
+        for (int i=0; i<NUM_THREADS; i++) {
+            printThreadPlacement(i, NUM_THREADS, i==0 ? pthread_self() : defaultPool->threads[i]);
+        }
+        printf("\n");
+    }
+    else if((mode>=OMP_LOC_WS && mode<=OMP_GLB_BB) || mode==SPARSE_CSR || mode==PIPE_BB || mode==HIER_BB){
+        #ifdef _OPENMP
+            NUM_THREADS=num_threads;
+            printf("%d\n", NUM_THREADS);
+            omp_set_num_threads(NUM_THREADS);
+            //The OMP runtime keeps the same threads for the next parallel regions, so they stay pinned
+            int* cpus=getPlacement(getenv(PLACESVARIABLE), NUM_THREADS);
+            #pragma omp parallel
+            {
+                if(cpus!=NULL) {
+                    pinCurrentThread(cpus[omp_get_thread_num()]);
+                }
+                printThreadPlacement(omp_get_thread_num(), omp_get_num_threads(), pthread_self());
+            }
+            free(cpus);
+            printf("\n");
+        #else
+            fprintf(stderr,"Forgot -fopenmp flag for MODE=%d, please to run in this mode insert that flag\n\n", mode);
+            exit(1);
+        #endif
+    }
+    else {
+        #ifdef _OPENMP
+                NUM_THREADS=1;
+                omp_set_num_threads(NUM_THREADS);
+                int* cpus=getPlacement(getenv(PLACESVARIABLE), NUM_THREADS);
+                if(cpus!=NULL) {
+                    pinCurrentThread(cpus[0]);
+                    printThreadPlacement(0, NUM_THREADS, pthread_self());
+                    free(cpus);
+                }
+        #else
+            fprintf(stderr,"Forgot -fopenmp flag for MODE=%d, please to run in this mode insert that flag\n\n", mode);
+            exit(1);
+        #endif
+    }
+    return NUM_THREADS;
+}
+/*
+ *  Name: getWallTime
+ *  Wall clock time for the measures: omp_get_wtime as always with -fopenmp, CLOCK_MONOTONIC without it (PTH_BB)
+ *  Output: double - Seconds from an arbitrary point
+ */
+double getWallTime(void) {
+    #ifdef _OPENMP
+        return omp_get_wtime();
+    #else
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (double)now.tv_sec+(double)now.tv_nsec*1e-9;
+    #endif
+}
+/*
+ *  Name: getAvailableCPUs
+ *  Number of CPUs that the process is allowed to use (taskset, cgroups of PBS), the limit of the threads of AUTO
+ *  Output: int - Number of CPUs, at least 1
+ */
+int getAvailableCPUs(void) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(cpu_set_t), &allowed)!=0 || CPU_COUNT(&allowed)==0) {
+        return MAX((int)sysconf(_SC_NPROCESSORS_ONLN), 1);
+    }
+    return CPU_COUNT(&allowed);
+}
+/*
+ *  Name: readAutoProfile
+ *  Looks in the calibration profile (a results file written by the program, as resultsGeneral.csv) for the best
+ *  mode and number of threads measured with the same size and test. The times of the same mode and threads are
+ *  averaged. Only the modes on a single matrix of one process are considered (not MPI, sparse, pipeline, AUTO)
+ *  Input:
+ *      path (const char*) - Path of the profile
+ *      n (int) - Size of the matrix
+ *      test (int) - Test mode
+ *      max_threads (int) - Maximum number of threads
+ *      plan (AutoPlan*) - Where to put mode and threads
+ *  Output: bool - true if the profile has at least a valid measure
+ */
+static bool readAutoProfile(const char* path, int n, int test, int max_threads, AutoPlan* plan) {
+    FILE* file=fopen(path, "r");
+    if(file==NULL) {
+        fprintf(stderr, "Couldn't open the profile %s, AUTO uses the default policy\n", path);
+        return false;
+    }
+    static double sum[END][MAX_THREADS+1];
+    static int count[END][MAX_THREADS+1];
+    memset(sum, 0, sizeof(sum));
+    memset(count, 0, sizeof(count));
+    char line[256];
+    char fcompile[20];
+    int findex, fmode, fdimension, ftest, fsamples, fthreads;
+    double favg_time;
+    while(fgets(line, sizeof(line), file)!=NULL) {
+        //The header and the broken lines don't have the 8 values
+        if(sscanf(line, "%d %19s %d %d %d %d %d %lf", &findex, fcompile, &fmode, &fdimension, &ftest, &fsamples, &fthreads, &favg_time)!=8) {
+            continue;
+        }
+        if(fdimension!=n || ftest!=test || fthreads<1 || fthreads>MIN(max_threads, MAX_THREADS) || favg_time<=0.0 ||
+           fmode<=START || fmode>=END || fmode==MPI_BB || fmode==SPARSE_CSR || fmode==PIPE_BB || fmode==AUTO) {
+            continue;
+        }
+        sum[fmode][fthreads]+=favg_time;
+        count[fmode][fthreads]++;
+    }
+    fclose(file);
+    double best=0.0;
+    for (int mode=START+1; mode<END; mode++) {
+        for (int threads=1; threads<=MAX_THREADS; threads++) {
+            if(count[mode][threads]>0 && (best==0.0 || sum[mode][threads]/count[mode][threads]<best)) {
+                best=sum[mode][threads]/count[mode][threads];
+                plan->mode=mode;
+                plan->threads=threads;
+            }
+        }
+    }
+    return best>0.0;
+}
+/*
+ *  Name: chooseAutoPlan
+ *  Policy of the AUTO mode. The block is the biggest power of 2 whose tiles of M and T fit together in L1 (the
+ *  L1 is private, so it doesn't depend on the threads). Each thread has to get at least CACHESIZEL2 of M and T,
+ *  otherwise starting the team costs more than it saves, so the small matrices stay on one thread (IMP_STAND)
+ *  and the threads grow with the size up to the CPUs available. Above CACHESIZEL3 the hierarchical blocking
+ *  (HIER_BB) is used, in between the OMP block-based one (OMP_GLB_BB). With TRANSPOSE_PROFILE the mode and the
+ *  threads are the best measured in that file for the same size and test, if there are
+ *  Input:
+ *      n (int) - Size of the matrix
+ *      element (size_t) - Bytes of an element
+ *      test (int) - Test mode (to look in the profile)
+ *      max_threads (int) - Maximum number of threads
+ *  Output: AutoPlan - Mode, threads and block to use
+ */
+AutoPlan chooseAutoPlan(int n, size_t element, int test, int max_threads) {
+    AutoPlan plan;
+    max_threads=MAX(MIN(max_threads, MAX_THREADS), 1);
+    const double bytes=2.0*n*n*element;
+    int sublength=MAXIMUMSUBLENGTH;
+    while(sublength>MINIMUMSUBLENGTH && 2.0*sublength*sublength*element>CACHESIZEL1D) {
+        sublength/=2;
+    }
+    plan.sublength=MAX(MIN(sublength, n/2), MINIMUMSUBLENGTH);
+    int threads=1;
+    while(threads*2<=max_threads && bytes/(threads*2)>=CACHESIZEL2) {
+        threads*=2;
+    }
+    plan.threads=threads;
+    if(bytes>CACHESIZEL3) {
+        plan.mode=HIER_BB;
+    }
+    else {
+        plan.mode=(threads==1) ? IMP_STAND : OMP_GLB_BB;
+    }
+    const char* profile=getenv(PROFILEVARIABLE);
+    if(profile!=NULL && readAutoProfile(profile, n, test, max_threads, &plan)) {
+        printf("AUTO: profile %s\n", profile);
+    }
+    if(plan.mode==SEQ || plan.mode==IMP_REC || plan.mode==IMP_STAND) {
+        plan.threads=1;
+    }
+    return plan;
+}
+/*
+ *  Name: matrixFootprint
+ *  Bytes of a matrix of allocateMatrixPerMode: the array of the rows and the rows (padded in the aligned modes)
+ */
+static long matrixFootprint(Mode mode, int n) {
+    const long cols=(mode==SEQ) ? n : getLeadingDimension(n);
+    return (long)sizeof(float*)*n+(long)sizeof(float)*n*cols;
+}
+/*
+ *  Name: allocateMatrixPerMode
+ *  Function that allocates a matrix based on the specified mode. The function chooses the type of matrix allocation (standard/aligned) depending on the execution mode (sequential standard, others aligned). For sequential execution, it allocates a regular square matrix.
+ *  The aligned ones are a single block with the rows padded as in getLeadingDimension, to be freed with freeMatrixPerMode
+ *  Input:
+ *      mode (Mode) - The execution mode that determines how the matrix should be allocated. Different modes require different types of matrix allocation (regular or aligned).
+ *      n (int) - Size of the matrix
+ *      sublength (int) - aligned memory allocation in parallel modes
+ *  Output:
+ *      M (float**) - The allocated matrix reffered
+ */
+float** allocateMatrixPerMode(Mode mode, int n) {
+    float** M=NULL;
+    switch (mode) {
+        case SEQ: {
+            M=createFloatSquareMatrix(n);
+        }
+            break;
+        case IMP_STAND:
+        case IMP_REC:
+        case OMP_LOC_WS:
+        case OMP_GLB_WS:
+        case OMP_LOC_BB:
+        case OMP_GLB_BB:
+        //case OMP_LOC_TB:
+        //case OMP_GLB_TB:
+        case MPI_BB:
+        case PTH_BB:
+        case PIPE_BB:
+        case HIER_BB:
+        {
+            //M=createFloatSquareMatrixAligned(n, sublength);
+            M=createFloatMatrixPadded(n, n, getLeadingDimension(n), MINIMUMSUBLENGTH);
+        }
+        break;
+        case START:
+        case END:
+            exit(1);
+            break;
+        default:
+            exit(1);
+            break;
+    }
+    const long bytes=matrixFootprint(mode, n);
+    atomic_fetch_add(&matrixAllocations, 1);
+    long now=atomic_fetch_add(&matrixBytes, bytes)+bytes;
+    long peak=atomic_load(&matrixPeakBytes);
+    while(now>peak && !atomic_compare_exchange_weak(&matrixPeakBytes, &peak, now)) {
+    }
+    return M;
+}
+/*
+ *  Name: freeMatrixPerMode
+ *  Frees a matrix allocated by allocateMatrixPerMode with the same mode (rows allocated one by one in
+ *  the sequential mode, a single padded block in the others)
+ *  Input:
+ *      mode (Mode) - The execution mode used in the allocation
+ *      M (float**) - The matrix (can be NULL)
+ *      n (int) - Size of the matrix
+ *  Output: none
+ */
+void freeMatrixPerMode(Mode mode, float** M, int n) {
+    if(M==NULL) {
+        return;
+    }
+    atomic_fetch_add(&matrixFrees, 1);
+    atomic_fetch_sub(&matrixBytes, matrixFootprint(mode, n));
+    if(mode==SEQ) {
+        freeMemory(M, n);
+    }
+    else {
+        freeMatrixContiguous(M);
+    }
+}
+/*
+ *  Name: getMemoryStats
+ *  Counters of the matrices allocated by allocateMatrixPerMode from the start of the program and peak of the
+ *  resident memory of the process (getrusage, in KB on Linux)
+ *  Output: MemoryStats - The counters
+ */
+MemoryStats getMemoryStats(void) {
+    MemoryStats stats={.allocations=atomic_load(&matrixAllocations), .frees=atomic_load(&matrixFrees),
+                       .bytes=atomic_load(&matrixBytes), .peak_bytes=atomic_load(&matrixPeakBytes), .peak_rss=0};
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage)==0) {
+        stats.peak_rss=(long)usage.ru_maxrss*KB;
+    }
+    return stats;
+}
+/*
+ *  Name: printMemoryStats
+ *  Prints the counters of getMemoryStats, at the end of a run
+ *  Output: none
+ */
+void printMemoryStats(void) {
+    MemoryStats stats=getMemoryStats();
+    printf("Matrices allocated: %ld (freed %ld), peak of the matrices: %.2f MB, peak RSS: %.2f MB (%s destination)\n", stats.allocations,
+           stats.frees, stats.peak_bytes/(double)(KB*KB), stats.peak_rss/(double)(KB*KB), eagerDestination() ? "eager" : "lazy");
+}
+/*
+ *  Name: initializeMatrix
+ *  Function that initializes a matrix based on test. Elements are populated with either random values, static values, or predefined values for symmetric or worst-case test scenarios.
+ *  Input:
+ *      M (float**) - The matrix to be initialized. This matrix will be filled with values based on the selected test type
+ *      test (Test) - The test type that determines how the matrix will be initialized. It can be RANDOM, STATIC, SYM, or WORST (0, 1, 2, 3)
+ *      n (int) - Size of Matrix
+ *  Output: none
+ */
+void initializeMatrix(float** M, Test test, int n) {
+    initializeMatrixRows(M, test, getTestSeed(test), n, 0, n);
+}
+typedef struct {
+    float** M;
+    Test test;
+    uint64_t seed;
+    int n;
+    int row_start;
+} InitJob;
+/*
+ *  Name: initializeRow
+ *  Tile of initializeMatrixRows: the local row i
+ */
+static void initializeRow(long i, int thread, void* arg) {
+    (void)thread;
+    const InitJob* job=arg;
+    float* row=job->M[i];
+    const int n=job->n;
+    //The test is the same for all the row, so the switch is outside the loops and they are vectorized
+    switch (job->test) {
+        case RANDOM:
+        case STATIC: {
+            //RANDOM and STATIC differ only for the seed (see getTestSeed)
+            const uint64_t seed=job->seed;
+            const long global=job->row_start+i;
+            #pragma omp simd
+            for (int j=0; j<n; j++) {
+                row[j]=counter_float2(seed, global, j, 0, 9999);
+            }
+            //M[i][j]=i*1.0/200000*n+j*1.0/100+1;
+        }
+        break;
+        case SYM:
+        case WORST:
+            #pragma omp simd
+            for (int j=0; j<n; j++) {
+                row[j]=5.0;
+            }
+            break;
+        default: break;
+    }
+}
+/*
+ *  Name: initializeMatrixRows
+ *  See initializeMatrix - Initializes only a block of rows of the global n x n matrix, the one held
+ *  by an MPI rank. Local row i is the global row row_start+i, so the worst case element is set only
+ *  by the owner of row n-2. The values come from counter_float2 on the global indexes, so the rows are
+ *  filled in parallel by the threads of the mode with runRows (first touch: each page ends in the memory of the NUMA node of
+ *  the thread that will work on it with a static schedule) and are the same for any number of threads or ranks
+ *  Input:
+ *      M (float**) - The local block (rows x n) to be initialized
+ *      test (Test) - The test type (RANDOM, STATIC, SYM, or WORST)
+ *      seed (uint64_t) - Seed of the matrix, the same on all the ranks (see getTestSeed)
+ *      n (int) - Size of the global Matrix
+ *      row_start (int) - Global index of the first local row
+ *      rows (int) - Number of local rows
+ *  Output: none
+ */
+void initializeMatrixRows(float** M, Test test, uint64_t seed, int n, int row_start, int rows) {
+    if(test<RANDOM || test>WORST) {
+        fprintf(stderr, "Unexpected Error\n");
+        exit(1);
+    }
+    InitJob job={.M=M, .test=test, .seed=seed, .n=n, .row_start=row_start};
+    runRows(rows, initializeRow, &job);
+    if(test==WORST && n-2>=row_start && n-2<row_start+rows) {
+        M[n-2-row_start][n-1]=3.0;
+    }
+}
+/*
+ *  Name: getDestination
+ *  Destination of executionProgram: the one of the caller, allocated now if there isn't
+ *  Input:
+ *      T (float***) - The destination of the caller (*T can be NULL)
+ *      mode (Mode) - The execution mode, for allocateMatrixPerMode
+ *      n (int) - Size of Matrix
+ *  Output: float** - *T
+ */
+static float** getDestination(float*** T, Mode mode, int n) {
+    if(*T==NULL) {
+        *T=allocateMatrixPerMode(mode, n);
+    }
+    return *T;
+}
+/*
+ *  Name: executionProgram
+ *  Function that handles matrix transposition based on the selected mode. The function checks if matrix meets the requirements for the selected mode (symmetry), and if not, it performs the necessary matrix transposition
+ *  The destination can be given by the caller (main allocates it before the measure, so the times don't include malloc and the page faults,
+ *  as in Final Results), otherwise it is allocated (with allocateMatrixPerMode) only when the transposition is needed, after the check
+ *  Input:
+ *      M (float**) - The matrix that has to be transposed
+ *      T (float***) - The destination: if *T is NULL the transposed is allocated here and returned in *T (to free with freeMatrixPerMode), it stays NULL if M is symmetric
+ *      mode (Mode) - The execution mode that determines the type of transposition and the parallelism
+ *      n (int) - Size of Matrix
+ *      sublength (int) - The sublength used in some parallelism modes for block-based transposition.
+ *  Output: bool - Returns `true` if the matrix was already valid. Returns `false` if a transposition was required and performed.
+ */
+bool executionProgram(float** M, float*** T, Mode mode, int n, int sublength) {
+    //A mismatch of the sums proves that M isn't symmetric, so the exact check is skipped
+    const bool rejected=prefilterEnabled() && !checkSymPrefilter(M, n);
+    switch (mode) {
+        case SEQ: {
+            if(rejected || !checkSym(M, n)) {
+                matTranspose(M, getDestination(T, mode, n), n);
+                return false;
+            }
+        }
+        break;
+        case IMP_STAND: {
+            if(rejected || !checkSymImpStandard(M, n, sublength)) {
+                matTransposeImpStandard(M, getDestination(T, mode, n), n, sublength);
+                return false;
+            }
+        }
+        break;
+        case IMP_REC: {
+            if(rejected || !checkSymImpRecursive(M, 0, n, 0, n, sublength)) {
+                matTransposeImpRecursive(M, getDestination(T, mode, n), 0, n, 0, n, sublength);
+                return false;
+            }
+        }
+        break;
+        // OMP variables can be seen via OMP_DISPLAY_ENV=TRUE
+        //In order to optimize it we use the following environment variables:
+        /*
+         * export OMP_NUM_THREADS=8          //Threads executing
+         * export OMP_SCHEDULE=static    //Dynamic schedule
+         * export OMP_PROC_BIND=TRUE         //Bind threads for cache locality
+         * export OMP_PLACES=cores           //Thread placement strategy
+         * export OMP_STACKSIZE=128M         //Maximum Matrix Dimension*2
+         * export OMP_WAIT_POLICY=ACTIVE     //Reduce thread idle time
+         * export OMP_NESTED=TRUE            //Enable nested parallelism for tasks
+         * export OMP_MAX_ACTIVE_LEVELS=OMP_NUM_THREADS    //Allow two levels of parallelism
+         * export OMP_CANCELLATION=TRUE      // Allow task cancellation
+         */
+        // WORK SHARING
+        case OMP_LOC_WS: {
+            #ifdef _OPENMP
+            if(rejected || !checkSymOMPLocal(M, n)) {
+                matTransposeOMPWorkSharing(M, getDestination(T, mode, n), n);
+                return false;
+            }
+            #endif
+        }
+        break;
+        case OMP_GLB_WS: {
+            #ifdef _OPENMP
+            if(rejected || !checkSymOMPGlobal(M, n)) {
+                matTransposeOMPWorkSharing(M, getDestination(T, mode, n), n);
+                return false;
+            }
+            #endif
+        }
+        break;
+        //FOR BLOCK BASED HAVE SIMD -O3 -march=native -ffast-math -funroll-loops
+        // -fopenmp -fopenmp-simd
+        // • export OMP_PROC_BIND=true
+        // • export OMP_PLACES=cores
+        // • OMP_DYNAMIC=TRUE
+        case OMP_LOC_BB: {
+            #ifdef _OPENMP
+            if(rejected || !checkSymOMPLocal(M, n)) {
+                matTransposeOMPBlockingBased(M, getDestination(T, mode, n), n, sublength);
+                return false;
+            }
+            #endif
+        }
+        break;
+        case OMP_GLB_BB: {
+            #ifdef _OPENMP
+            if(rejected || !checkSymOMPGlobal(M, n)) {
+                matTransposeOMPBlockingBased(M, getDestination(T, mode, n), n, sublength);
+                return false;
+            }
+            #endif
+        }
+        break;
+        case HIER_BB: {
+            #ifdef _OPENMP
+            if(rejected || !checkSymOMPGlobal(M, n)) {
+                matTransposeHierarchical(M, getDestination(T, mode, n), n, sublength);
+                return false;
+            }
+            #endif
+        }
+        break;
+        //FOR TASK BASED WE ACTIVATE compile -O3 -march=native
+        // • export OMP_DYNAMIC=TRUE
+        // • export OMP_NESTED=TRUE
+        // • export OMP_MAX_ACTIVE_LEVELS=2
+        // • export OMP_PROC_BIND=spread
+        /*case OMP_LOC_TB: {
+            #ifdef _OPENMP
+            omp_set_nested(1);
+            if(!checkSymOMPLocal(M, n)) {
+                #pragma omp parallel
+                {
+                    #pragma omp single
+                    {
+                        matTransposeOMPTaskBased(M, T, 0, n, 0, n, sublength);
+                    }*/
+                    /*int start=(n/(omp_get_num_threads()*2))*omp_get_thread_num();
+                    int end=(n/(omp_get_num_threads()*2))*(omp_get_thread_num()+1);
+                    matTransposeOMPTaskBased(M, T, start, end, start, end, sublength);
+                }
+                return false;
+            }
+            #endif
+        }
+        break;*/
+        /*case OMP_GLB_TB: {
+            #ifdef _OPENMP
+            if(!checkSymOMPGlobal(M, n)) {
+                #pragma omp parallel
+                {
+                    #pragma omp single
+                    matTransposeOMPTaskBased(M, T, 0, n, 0, n, sublength);*/
+                   /* int start=(n/(omp_get_num_threads()*2))*omp_get_thread_num();
+                    int end=(n/(omp_get_num_threads()*2))*(omp_get_thread_num()+1);
+                    matTransposeOMPTaskBased(M, T, start, end, start, end, sublength);
+                }
+                return false;
+            }
+            #endif
+        }
+        break;*/
+        //PTHREADS POOL (no OMP runtime, the pool is created by threadInit)
+        case PTH_BB: {
+            if(rejected || !checkSymPthreads(getDefaultThreadPool(), M, n, sublength)) {
+                matTransposePthreads(getDefaultThreadPool(), M, getDestination(T, mode, n), n, sublength);
+                return false;
+            }
+        }
+        break;
+        //Distributed matrices are held in row blocks and go through executionProgramMPI
+        case MPI_BB:
+            fprintf(stderr, "MODE=%d has to be executed with executionProgramMPI\n", mode);
+            exit(1);
+            break;
+        //Sparse matrices are not float** and go through executionProgramSparse
+        case SPARSE_CSR:
+            fprintf(stderr, "MODE=%d has to be executed with executionProgramSparse\n", mode);
+            exit(1);
+            break;
+        //The pipeline keeps its buffers and goes through executionPipeline
+        case PIPE_BB:
+            fprintf(stderr, "MODE=%d has to be executed with executionPipeline\n", mode);
+            exit(1);
+            break;
+        default:
+            exit(1);
+            break;
+    }
+    //M is its own transposed: a T of the caller isn't written and nothing is allocated
+    return true;
+}
+/*
+ *  Name: openFilesAvgPerMode
+ *  Function that opens specific files based on the mode and writes the average time for a particular mode of matrix operation in a particular file
+ *  Input:
+ *      code (const char*) - A string representing the code identifier
+ *      mode (const int) - The execution mode that determines which file will be opened and written to
+ *      n (const int) - The dimension of the matrix (number of rows/columns)
+ *      test (const int) - Test for data in matrix
+ *      samples (const int) - The number of samples.
+ *      num_threads (const int) - The number of threads
+ *      avg_time (const double) - The average time taken
+ */
+void openFilesAvgPerMode(const char* code, const int mode, const int n, const int test, const int samples, const int num_threads, const double avg_time) {
+    openFile(FILENAMEGEN, code, mode, n, test, samples, num_threads, avg_time, 1);
+    switch (mode) {
+        case SEQ:
+            openFile(FILENAMESEQ, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case IMP_STAND:
+            openFile(FILENAMEIMPSTAND, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case IMP_REC:
+            openFile(FILENAMEIMPREC, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case OMP_LOC_WS:
+            openFile(FILENAMEOMPLOCWS, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case OMP_GLB_WS:
+            openFile(FILENAMEOMPGLBWS, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case OMP_LOC_BB:
+            openFile(FILENAMEOMPLOCBB, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case OMP_GLB_BB:
+            openFile(FILENAMEOMPGLBBB, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case MPI_BB:
+            openFile(FILENAMEMPIBB, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case PTH_BB:
+            openFile(FILENAMEPTHBB, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case SPARSE_CSR:
+            openFile(FILENAMESPARSE, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case PIPE_BB:
+            openFile(FILENAMEPIPE, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case HIER_BB:
+            openFile(FILENAMEHIER, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case AUTO:
+            openFile(FILENAMEAUTO, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        /*case OMP_LOC_TB:
+            openFile(FILENAMEOMPLOCTB, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;
+        case OMP_GLB_TB:
+            openFile(FILENAMEOMPGLBTB, code, mode, n, test, samples, num_threads, avg_time, 1);
+            break;*/
+        default:
+            exit(1);
+            break;
+    }
+}
+/*
+ *  Name: openFilesResultsPerMode
+ *  Function that opens specific result files based on the mode and writes the execution time for a particular mode of matrix operation.
+ *  Input:
+ *      code (const char*) - A string representing the code identifier
+ *      mode (const int) - The execution mode that determines which file will be opened and written to
+ *      n (const int) - The dimension of the matrix (number of rows/columns)
+ *      test (const int) - The test type used for matrix generation.
+ *      samples (const int) - The number of samples for benchmarking.
+ *      num_threads (const int) - The number of threads used in parallelism
+ *      time (const double) - The execution time taken for the operation
+ */
+void openFilesResultsPerMode(const char* code, const int mode, const int n, const int test, const int samples, const int num_threads, const double time) {
+    openFile(FILENAMETGEN, code, mode, n, test, samples, num_threads, time, 0);
+    switch (mode) {
+        case SEQ:
+            openFile(FILENAMETSEQ, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case IMP_STAND:
+            openFile(FILENAMETIMPSTAND, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case IMP_REC:
+            openFile(FILENAMETIMPREC, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case OMP_LOC_WS:
+            openFile(FILENAMETOMPLOCWS, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case OMP_GLB_WS:
+            openFile(FILENAMETOMPGLBWS, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case OMP_LOC_BB:
+            openFile(FILENAMETOMPLOCBB, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case OMP_GLB_BB:
+            openFile(FILENAMETOMPGLBBB, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case MPI_BB:
+            openFile(FILENAMETMPIBB, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case PTH_BB:
+            openFile(FILENAMETPTHBB, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case SPARSE_CSR:
+            openFile(FILENAMETSPARSE, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case PIPE_BB:
+            openFile(FILENAMETPIPE, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case HIER_BB:
+            openFile(FILENAMETHIER, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case AUTO:
+            openFile(FILENAMETAUTO, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        /*case OMP_LOC_TB:
+            openFile(FILENAMETOMPLOCTB, code, mode, n, test, samples, num_threads, time, 0);
+            break;
+        case OMP_GLB_TB:
+            openFile(FILENAMETOMPGLBTB, code, mode, n, test, samples, num_threads, time, 0);
+            break;*/
+        default:
+            exit(1);
+            break;
+    }
+}
+/*
+ * Name: bubblesort
+ * Reorder an Array in ascending order
+ */
+void bubbleSort(double* a, int size) {
+    for (int i=0; i<(size-1); i++) {
         for (int j=0; j<(size-1-i); j++) {
             if(a[j]>a[j+1]) {
                 double temp=a[j+1];
@@ -1061,3 +2755,2072 @@ void bubbleSort(double* a, int size) {
         }
     }
 }
+/*
+ * Name: packSymmetric
+ * Convert a symmetric matrix (checked before with one of the checkSym) in the packed format, which
+ * keeps only the lower triangle: n*(n+1)/2 floats instead of n*n. It's one streaming pass, the first
+ * i+1 elements of row i are contiguous both in M and in the packed array, so each row is a copy
+ * (the rows are given in small chunks because they have different lengths)
+ * Input:
+ *      M (float**) - The symmetric matrix (it's not freed)
+ *      n (int) - Size of Matrix
+ * Output: PackedSymMatrix* - The packed matrix, to be freed with freePacked
+ */
+PackedSymMatrix* packSymmetric(float** M, int n) {
+    PackedSymMatrix* P=malloc(sizeof(PackedSymMatrix));
+    if(P==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    P->n=n;
+    P->data=malloc(sizeof(float)*PACKEDINDEX(n, 0));
+    if(P->data==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int i=0; i<n; i++) {
+        memcpy(P->data+PACKEDINDEX(i, 0), M[i], sizeof(float)*(i+1));
+    }
+    return P;
+}
+/*
+ * Name: packedGet
+ * Element [i][j] of a packed symmetric matrix, the upper triangle is read from its mirror
+ * Input:
+ *      P (const PackedSymMatrix*) - The packed matrix
+ *      i, j (int) - Row and column
+ * Output: float - The element
+ */
+float packedGet(const PackedSymMatrix* P, int i, int j) {
+    return (j<=i) ? P->data[PACKEDINDEX(i, j)] : P->data[PACKEDINDEX(j, i)];
+}
+/*
+ * Name: packedSet
+ * Write the element [i][j] of a packed symmetric matrix, so also [j][i] (the matrix stays symmetric)
+ * Input:
+ *      P (PackedSymMatrix*) - The packed matrix
+ *      i, j (int) - Row and column
+ *      value (float) - The new value
+ * Output: none
+ */
+void packedSet(PackedSymMatrix* P, int i, int j, float value) {
+    if(j<=i) {
+        P->data[PACKEDINDEX(i, j)]=value;
+    }
+    else {
+        P->data[PACKEDINDEX(j, i)]=value;
+    }
+}
+/*
+ * Name: matTransposePacked
+ * Transposition of a packed symmetric matrix: it is its own transpose, so nothing is copied and the
+ * same matrix is returned (like executionProgram when the check is true)
+ * Input: P (PackedSymMatrix*) - The packed matrix
+ * Output: PackedSymMatrix* - The transpose, the same P
+ */
+PackedSymMatrix* matTransposePacked(PackedSymMatrix* P) {
+    return P;
+}
+/*
+ * Name: unpackSymmetric
+ * Rebuild the full matrix from the packed one (M has to be allocated outside)
+ * Input:
+ *      P (const PackedSymMatrix*) - The packed matrix
+ *      M (float**) - Destination n x n matrix
+ * Output: none
+ */
+void unpackSymmetric(const PackedSymMatrix* P, float** M) {
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int i=0; i<P->n; i++) {
+        memcpy(M[i], P->data+PACKEDINDEX(i, 0), sizeof(float)*(i+1));
+        for (int j=i+1; j<P->n; j++) {
+            M[i][j]=P->data[PACKEDINDEX(j, i)];
+        }
+    }
+}
+/*
+ * Name: freePacked
+ * Free a packed matrix created with packSymmetric
+ * Input: P (PackedSymMatrix*) - The packed matrix (can be NULL)
+ * Output: none
+ */
+void freePacked(PackedSymMatrix* P) {
+    if(P!=NULL) {
+        free(P->data);
+        free(P);
+    }
+}
+/*
+ * Name: trackMatrix
+ * Start tracking the symmetry of a matrix that will be modified in place. The matrix is divided in the
+ * blocks of checkSymImpStandard and for each pair of mirrored blocks is kept if it was written after the
+ * last check (dirty) and if it was different at the last check. At the beginning all the pairs are
+ * dirty, so the first check is complete
+ * Input:
+ *      M (float**) - The allocated in heap matrix (it remains of the caller)
+ *      n (int) - Size of Matrix
+ *      sublength (int) - Blocks of a submatrix
+ * Output: TrackedMatrix* - The tracked matrix, to be freed with untrackMatrix
+ */
+TrackedMatrix* trackMatrix(float** M, int n, int sublength) {
+    TrackedMatrix* TM=malloc(sizeof(TrackedMatrix));
+    if(TM==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    TM->M=M;
+    TM->n=n;
+    TM->sublength=sublength;
+    TM->blocks=(n+sublength-1)/sublength;
+    const long pairs=PACKEDINDEX(TM->blocks, 0);
+    TM->dirty=malloc(pairs);
+    TM->asymmetric=calloc(pairs, 1);
+    TM->dirtyList=malloc(sizeof(long)*pairs);
+    if(TM->dirty==NULL || TM->asymmetric==NULL || TM->dirtyList==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    memset(TM->dirty, 1, pairs);
+    for (long p=0; p<pairs; p++) {
+        TM->dirtyList[p]=p;
+    }
+    TM->dirtyCount=pairs;
+    TM->asymmetricCount=0;
+    return TM;
+}
+/*
+ * Name: trackedMarkDirty
+ * Signal that the element [i][j] was modified (for who writes directly in M), so the pair of blocks
+ * containing [i][j] and [j][i] will be checked again. The writes have to be done by one thread at a time
+ * Input:
+ *      TM (TrackedMatrix*) - The tracked matrix
+ *      i, j (int) - Row and column of the modified element
+ * Output: none
+ */
+void trackedMarkDirty(TrackedMatrix* TM, int i, int j) {
+    int bi=i/TM->sublength;
+    int bj=j/TM->sublength;
+    long pair=(bj<=bi) ? PACKEDINDEX(bi, bj) : PACKEDINDEX(bj, bi);
+    if(!TM->dirty[pair]) {
+        TM->dirty[pair]=1;
+        TM->dirtyList[TM->dirtyCount++]=pair;
+    }
+}
+/*
+ * Name: trackedSet
+ * Write an element of the tracked matrix and mark its pair of blocks as dirty
+ * Input:
+ *      TM (TrackedMatrix*) - The tracked matrix
+ *      i, j (int) - Row and column
+ *      value (float) - The new value
+ * Output: none
+ */
+void trackedSet(TrackedMatrix* TM, int i, int j, float value) {
+    TM->M[i][j]=value;
+    trackedMarkDirty(TM, i, j);
+}
+/*
+ * Name: checkSymTracked
+ * See checkSymImpStandard - Check again only the dirty pairs of blocks (in parallel) and update the number
+ * of pairs that are different, so the work is proportional to the blocks written after the last check
+ * and not to N². The matrix is symmetric if no pair is different
+ * Input:
+ *      TM (TrackedMatrix*) - The tracked matrix
+ * Output: bool (true - Matrix is symmetric; false - The matrix doesn't concide
+ * with its transpose
+ */
+bool checkSymTracked(TrackedMatrix* TM) {
+    long delta=0;
+    #pragma omp parallel for schedule(dynamic, 16) reduction(+:delta)
+    for (long d=0; d<TM->dirtyCount; d++) {
+        long pair=TM->dirtyList[d];
+        long bi=(long)((sqrt(8.0*pair+1)-1)/2);
+        while(PACKEDINDEX(bi, 0)>pair) {
+            bi--;
+        }
+        while(PACKEDINDEX(bi+1, 0)<=pair) {
+            bi++;
+        }
+        long bj=pair-PACKEDINDEX(bi, 0);
+        unsigned char different=!checkSymTile(TM->M, TM->n, (int)bi*TM->sublength, (int)bj*TM->sublength, TM->sublength);
+        delta+=different-TM->asymmetric[pair];
+        TM->asymmetric[pair]=different;
+        TM->dirty[pair]=0;
+    }
+    TM->asymmetricCount+=delta;
+    TM->dirtyCount=0;
+    return TM->asymmetricCount==0;
+}
+/*
+ * Name: untrackMatrix
+ * Stop tracking a matrix, freeing the tracking structures (not the matrix)
+ * Input: TM (TrackedMatrix*) - The tracked matrix (can be NULL)
+ * Output: none
+ */
+void untrackMatrix(TrackedMatrix* TM) {
+    if(TM!=NULL) {
+        free(TM->dirty);
+        free(TM->asymmetric);
+        free(TM->dirtyList);
+        free(TM);
+    }
+}
+/*
+ * Name: createTransposedView
+ * Create a transposed view of M: T[i][j]=M[j][i] without transposing all the matrix. T is divided in
+ * tiles of sublength x sublength and a tile is transposed with the block kernel only when one of its
+ * elements is requested, in a small cache of tiles. When the cache is full the tiles are replaced in
+ * round robin. The view is of a single consumer (not thread safe) and M mustn't change while it's used
+ * Input:
+ *      M (float**) - The matrix to transpose (it remains of the caller)
+ *      n (int) - Size of Matrix
+ *      sublength (int) - Side of a tile
+ *      slots (int) - Number of tiles in the cache
+ * Output: TransposedView* - The view, to be freed with freeTransposedView
+ */
+TransposedView* createTransposedView(float** M, int n, int sublength, int slots) {
+    TransposedView* V=malloc(sizeof(TransposedView));
+    if(V==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    V->M=M;
+    V->n=n;
+    V->sublength=sublength;
+    V->blocks=(n+sublength-1)/sublength;
+    V->slots=MAX(1, MIN(slots, V->blocks*V->blocks));
+    V->slotOf=malloc(sizeof(int)*V->blocks*V->blocks);
+    V->tileOf=malloc(sizeof(long)*V->slots);
+    if(V->slotOf==NULL || V->tileOf==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for (long t=0; t<(long)V->blocks*V->blocks; t++) {
+        V->slotOf[t]=-1;
+    }
+    for (int k=0; k<V->slots; k++) {
+        V->tileOf[k]=-1;
+    }
+    V->victim=0;
+    V->cache=createFloatMatrixContiguous(V->slots*sublength, sublength, MINIMUMSUBLENGTH);
+    V->materialized=0;
+    return V;
+}
+/*
+ * Name: viewTileRow
+ * Row i of T restricted to the tile column bj: sublength contiguous floats T[i][bj*sublength...]
+ * (less in the last tile if n is not a multiple). If the tile isn't in the cache it is transposed
+ * from M now, replacing the oldest one. It's the fast way to read a band of columns of T
+ * Input:
+ *      V (TransposedView*) - The view
+ *      i (int) - Row of T
+ *      bj (int) - Tile column
+ * Output: const float* - The row of the tile, valid until the tile is replaced
+ */
+const float* viewTileRow(TransposedView* V, int i, int bj) {
+    const int t=V->sublength;
+    const int bi=i/t;
+    const long tile=(long)bi*V->blocks+bj;
+    int slot=V->slotOf[tile];
+    if(slot<0) {
+        slot=V->victim;
+        V->victim=(V->victim+1)%V->slots;
+        if(V->tileOf[slot]>=0) {
+            V->slotOf[V->tileOf[slot]]=-1;
+        }
+        //Tile (bi, bj) of T is the block (bj, bi) of M transposed
+        matTransposeTile(V->M, V->cache, bj*t, bi*t, slot*t, 0, MIN(t, V->n-bj*t), MIN(t, V->n-bi*t), t);
+        V->slotOf[tile]=slot;
+        V->tileOf[slot]=tile;
+        V->materialized++;
+    }
+    return V->cache[slot*t+i%t];
+}
+/*
+ * Name: viewGet
+ * Element T[i][j] of the transposed view (see viewTileRow)
+ * Input:
+ *      V (TransposedView*) - The view
+ *      i, j (int) - Row and column of T
+ * Output: float - T[i][j]
+ */
+float viewGet(TransposedView* V, int i, int j) {
+    return viewTileRow(V, i, j/V->sublength)[j%V->sublength];
+}
+/*
+ * Name: viewMaterializeAll
+ * Materialize all the transposed view in T, when the consumer needs all of it. The tiles are
+ * transposed in parallel from M with the block kernel, as in matTransposeOMPBlockingBased
+ * Input:
+ *      V (TransposedView*) - The view
+ *      T (float**) - Destination n x n matrix (allocated outside)
+ * Output: none
+ */
+void viewMaterializeAll(TransposedView* V, float** T) {
+    const int t=V->sublength;
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int bi=0; bi<V->blocks; bi++) {
+        for (int bj=0; bj<V->blocks; bj++) {
+            matTransposeTile(V->M, T, bj*t, bi*t, bi*t, bj*t, MIN(t, V->n-bj*t), MIN(t, V->n-bi*t), t);
+        }
+    }
+}
+/*
+ * Name: freeTransposedView
+ * Free a transposed view (not M)
+ * Input: V (TransposedView*) - The view (can be NULL)
+ * Output: none
+ */
+void freeTransposedView(TransposedView* V) {
+    if(V!=NULL) {
+        freeMatrixContiguous(V->cache);
+        free(V->slotOf);
+        free(V->tileOf);
+        free(V);
+    }
+}
+/*
+ * Name: createCSR
+ * Create in the heap a sparse matrix in CSR (or CSC) format with space for nnz elements
+ * Input:
+ *      rows (int) - Number of rows (columns for CSC)
+ *      cols (int) - Number of columns (rows for CSC)
+ *      nnz (long) - Number of elements different from zero
+ * Output: CSRMatrix* - The matrix, to be freed with freeCSR
+ */
+CSRMatrix* createCSR(int rows, int cols, long nnz) {
+    CSRMatrix* A=malloc(sizeof(CSRMatrix));
+    if(A==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    A->rows=rows;
+    A->cols=cols;
+    A->nnz=nnz;
+    A->ptr=malloc(sizeof(long)*(rows+1));
+    A->idx=malloc(sizeof(int)*MAX(nnz, 1));
+    A->val=malloc(sizeof(float)*MAX(nnz, 1));
+    if(A->ptr==NULL || A->idx==NULL || A->val==NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    return A;
+}
+/*
+ * Name: freeCSR
+ * Free a sparse matrix created with createCSR
+ * Input: A (CSRMatrix*) - The matrix (can be NULL)
+ * Output: none
+ */
+void freeCSR(CSRMatrix* A) {
+    if(A!=NULL) {
+        free(A->ptr);
+        free(A->idx);
+        free(A->val);
+        free(A);
+    }
+}
+/*
+ * Name: generateSparseCSR
+ * See initializeMatrix - Generates directly in CSR a n x n matrix with about n/SPARSEDENSITY elements
+ * per row, without passing from the dense one.
+ *      RANDOM, STATIC - In each row one element at a random column in each interval of SPARSEDENSITY columns,
+ *                       with column and value from the counter-based generator, so rows are generated in parallel
+ *      SYM - Symmetric pattern: the band |i-j|<=1 and the diagonals at a distance multiple of
+ *            SPARSEDENSITY, all with the same value
+ *      WORST - SYM with only the element [n-2][n-1] different
+ * Input:
+ *      test (Test) - The test type
+ *      n (int) - Size of Matrix
+ * Output: CSRMatrix* - The generated matrix
+ */
+CSRMatrix* generateSparseCSR(Test test, int n) {
+    const int stride=MIN(SPARSEDENSITY, n);
+    //Upper bound of the elements of a row: one per interval or 2 per distance multiple of stride + 3
+    const long per_row=(n+stride-1)/stride+2;
+    CSRMatrix* A=createCSR(n, n, per_row*n);
+    const uint64_t seed=getTestSeed(test);
+    if(test==RANDOM || test==STATIC) {
+        //One element per interval of stride columns, so every row has the same count and is generated in parallel
+        const int count=(n+stride-1)/stride;
+        const uint64_t column_seed=splitmix64(seed);
+        #pragma omp parallel for schedule(static)
+        for (int i=0; i<n; i++) {
+            long nnz=(long)i*count;
+            A->ptr[i]=nnz;
+            for (int j=0; j<n; j+=stride) {
+                A->idx[nnz]=j+splitmix64(column_seed^splitmix64(((uint64_t)i<<32)|(uint32_t)j))%MIN(stride, n-j);
+                A->val[nnz]=counter_float2(seed, i, A->idx[nnz], 0, 9999);
+                nnz++;
+            }
+        }
+        A->ptr[n]=(long)n*count;
+        A->nnz=A->ptr[n];
+        return A;
+    }
+    long nnz=0;
+    for (int i=0; i<n; i++) {
+        A->ptr[i]=nnz;
+        switch (test) {
+            case SYM:
+            case WORST: {
+                //Columns at distance multiple of stride merged in order with the band i-1, i+1
+                int band[2]={i-1, i+1};
+                int b=0;
+                for (int j=i%stride; j<n; j+=stride) {
+                    while(b<2 && band[b]<j) {
+                        if(band[b]>=0 && band[b]<n) {
+                            A->idx[nnz]=band[b];
+                            A->val[nnz]=5.0;
+                            nnz++;
+                        }
+                        b++;
+                    }
+                    if(b<2 && band[b]==j) {
+                        b++;
+                    }
+                    A->idx[nnz]=j;
+                    A->val[nnz]=5.0;
+                    nnz++;
+                }
+                for (; b<2; b++) {
+                    if(band[b]>=0 && band[b]<n) {
+                        A->idx[nnz]=band[b];
+                        A->val[nnz]=5.0;
+                        nnz++;
+                    }
+                }
+            }
+                break;
+            default: fprintf(stderr, "Unexpected Error\n"); exit(1);
+        }
+    }
+    A->ptr[n]=nnz;
+    A->nnz=nnz;
+    //The last element of the row n-2 is the one in column n-1 (band)
+    if(test==WORST && n>=2) {
+        A->val[A->ptr[n-1]-1]=3.0;
+    }
+    return A;
+}
+/*
+ * Name: findCSR
+ * Binary search of a column in a row of a CSR matrix (the columns of a row are ordered)
+ * Input:
+ *      A (const CSRMatrix*) - The matrix
+ *      row (int) - Row
+ *      col (int) - Column to find
+ * Output: long - Position of the element in idx and val, -1 if it is zero
+ */
+static long findCSR(const CSRMatrix* A, int row, int col) {
+    long low=A->ptr[row];
+    long high=A->ptr[row+1]-1;
+    while(low<=high) {
+        long mid=low+(high-low)/2;
+        if(A->idx[mid]==col) {
+            return mid;
+        }
+        if(A->idx[mid]<col) {
+            low=mid+1;
+        }
+        else {
+            high=mid-1;
+        }
+    }
+    return -1;
+}
+/*
+ * Name: checkSymCSR
+ * See checkSymOMPLocal - Symmetry check of a CSR matrix without densifying it. For each element [i][j]
+ * its mirror is searched with a binary search in the row j, so the work is nnz*log(elements per row).
+ * The matrix is structurally symmetric if all the mirrors are stored and numerically symmetric if
+ * their values are equal (a missing mirror is a zero, so a stored zero doesn't break it). The rows are
+ * divided between the threads and, as in the Local algorithm, the others stop when both are false
+ * Input:
+ *      A (const CSRMatrix*) - The sparse matrix (square)
+ *      structural (bool*) - Output, true if the pattern is symmetric (can be NULL)
+ * Output: bool (true - Matrix is numerically symmetric; false - The matrix doesn't concide
+ * with its transpose
+ */
+bool checkSymCSR(const CSRMatrix* A, bool* structural) {
+    bool numeric=true;
+    bool pattern=true;
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i=0; i<A->rows; i++) {
+        bool localNumeric, localPattern;
+        #pragma omp atomic read
+        localNumeric=numeric;
+        #pragma omp atomic read
+        localPattern=pattern;
+        for (long k=A->ptr[i]; k<A->ptr[i+1] && (localNumeric || localPattern); k++) {
+            int j=A->idx[k];
+            if(j==i) {
+                continue;
+            }
+            long mirror=findCSR(A, j, i);
+            float value=(mirror<0) ? 0.0f : A->val[mirror];
+            if(mirror<0 && localPattern) {
+                localPattern=false;
+                #pragma omp atomic write
+                pattern=false;
+            }
+            if(ABS_DIFF(A->val[k], value)>ERROR && localNumeric) {
+                localNumeric=false;
+                #pragma omp atomic write
+                numeric=false;
+            }
+        }
+    }
+    if(structural!=NULL) {
+        *structural=pattern;
+    }
+    return numeric;
+}
+/*
+ * Name: csrToCSC
+ * Transposition of a sparse matrix: from CSR to CSC, which has the same arrays of the CSR of the
+ * transpose. It's a parallel counting sort on the columns:
+ *      1. Each thread counts the elements per column of its block of rows in its own histogram
+ *      2. For each column the counts are transformed in the offset of each thread inside the column
+ *         and a prefix sum on the columns gives the start of each column
+ *      3. Each thread scatters its rows in order, so the rows of each column come out ordered
+ * The histograms are threads x cols, all the rest is linear in nnz
+ * Input:
+ *      A (const CSRMatrix*) - The sparse matrix in CSR
+ *      C (CSRMatrix*) - Destination in CSC, created with createCSR(A->cols, A->rows, A->nnz)
+ * Output: none
+ */
+void csrToCSC(const CSRMatrix* A, CSRMatrix* C) {
+    int threads=1;
+    #ifdef _OPENMP
+        threads=omp_get_max_threads();
+    #endif
+    const int cols=A->cols;
+    long* counts=calloc((size_t)threads*cols, sizeof(long));
+    if(counts==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    #pragma omp parallel num_threads(threads)
+    {
+        int t=0, p=1;
+        #ifdef _OPENMP
+            t=omp_get_thread_num();
+            p=omp_get_num_threads();
+        #endif
+        long* local=counts+(size_t)t*cols;
+        int start=(int)((long)A->rows*t/p);
+        int end=(int)((long)A->rows*(t+1)/p);
+        for (long k=A->ptr[start]; k<A->ptr[end]; k++) {
+            local[A->idx[k]]++;
+        }
+        #pragma omp barrier
+        #pragma omp for schedule(static)
+        for (int c=0; c<cols; c++) {
+            long running=0;
+            for (int q=0; q<p; q++) {
+                long count=counts[(size_t)q*cols+c];
+                counts[(size_t)q*cols+c]=running;
+                running+=count;
+            }
+            C->ptr[c+1]=running;
+        }
+        #pragma omp single
+        {
+            C->ptr[0]=0;
+            for (int c=0; c<cols; c++) {
+                C->ptr[c+1]+=C->ptr[c];
+            }
+        }
+        for (int i=start; i<end; i++) {
+            for (long k=A->ptr[i]; k<A->ptr[i+1]; k++) {
+                int c=A->idx[k];
+                long position=C->ptr[c]+local[c]++;
+                C->idx[position]=i;
+                C->val[position]=A->val[k];
+            }
+        }
+    }
+    C->nnz=A->nnz;
+    free(counts);
+}
+/*
+ * Name: executionProgramSparse
+ * See executionProgram - Check of symmetry of the CSR matrix and, if not symmetric, conversion in CSC
+ * Input:
+ *      A (const CSRMatrix*) - The sparse matrix in CSR
+ *      C (CSRMatrix*) - Destination in CSC
+ * Output: bool - Returns `true` if the matrix was already symmetric, `false` if the transposition was performed.
+ */
+bool executionProgramSparse(const CSRMatrix* A, CSRMatrix* C) {
+    if(!checkSymCSR(A, NULL)) {
+        csrToCSC(A, C);
+        return false;
+    }
+    return true;
+}
+/*
+ * Name: executionSampleSparse
+ * One sample of the sparse mode: generation of the CSR matrix, allocation of the CSC one and the timing
+ * of executionProgramSparse
+ *   Input:
+ *      test (Test) - The test type used to generate the matrix
+ *      n (int) - Size of the Matrix
+ * Output: double - Time elapsed
+ */
+double executionSampleSparse(Test test, int n) {
+    CSRMatrix* A=generateSparseCSR(test, n);
+    CSRMatrix* C=createCSR(n, n, A->nnz);
+    double time=0.0;
+    #ifdef _OPENMP
+        double start=omp_get_wtime();
+        bool symmetric=executionProgramSparse(A, C);
+        time=omp_get_wtime()-start;
+        printf("Time Elapsed (get time)=%.12f%s\n", time, symmetric ? " (symmetric)" : "");
+    #endif
+    freeCSR(A);
+    freeCSR(C);
+    return time;
+}
+/*
+ * Name: pipelineProducer
+ * First stage of the pipeline (own thread): loads the next matrix of the stream in a free slot of the
+ * ring, waiting while all the slots are still used by the other stages
+ * Input: arg (void*) - The Pipeline
+ * Output: void* - NULL
+ */
+static void* pipelineProducer(void* arg) {
+    Pipeline* pipe=arg;
+    #ifdef _OPENMP
+        omp_set_num_threads(1);
+    #endif
+    for (long item=0; item<pipe->stream; item++) {
+        pthread_mutex_lock(&pipe->lock);
+        while(item-pipe->consumed>=pipe->slots) {
+            pthread_cond_wait(&pipe->changed, &pipe->lock);
+        }
+        pthread_mutex_unlock(&pipe->lock);
+        initializeMatrix(pipe->M[item%pipe->slots], pipe->test, pipe->n);
+        pthread_mutex_lock(&pipe->lock);
+        pipe->produced++;
+        pthread_cond_broadcast(&pipe->changed);
+        pthread_mutex_unlock(&pipe->lock);
+    }
+    return NULL;
+}
+/*
+ * Name: pipelineConsumer
+ * Last stage of the pipeline (own thread): reads the result of each matrix (T, or M if it was symmetric)
+ * computing a checksum, as the user of the transposition would, and then frees the slot
+ * Input: arg (void*) - The Pipeline
+ * Output: void* - NULL
+ */
+static void* pipelineConsumer(void* arg) {
+    Pipeline* pipe=arg;
+    for (long item=0; item<pipe->stream; item++) {
+        pthread_mutex_lock(&pipe->lock);
+        while(pipe->transposed<=item) {
+            pthread_cond_wait(&pipe->changed, &pipe->lock);
+        }
+        pthread_mutex_unlock(&pipe->lock);
+        const int slot=item%pipe->slots;
+        float** R=pipe->symmetric[slot] ? pipe->M[slot] : pipe->T[slot];
+        double checksum=0.0;
+        for (int i=0; i<pipe->n; i++) {
+            for (int j=0; j<pipe->n; j++) {
+                checksum+=R[i][j];
+            }
+        }
+        pthread_mutex_lock(&pipe->lock);
+        pipe->checksum+=checksum;
+        pipe->consumed++;
+        pthread_cond_broadcast(&pipe->changed);
+        pthread_mutex_unlock(&pipe->lock);
+    }
+    return NULL;
+}
+/*
+ * Name: executionPipeline
+ * Check and transposition of a stream of matrices in a pipeline of three stages connected by a ring of
+ * buffers: load (producer thread), check + transposition (the caller with its OMP team, as OMP_GLB_BB)
+ * and consume (consumer thread). While a matrix is transposed, the next one is loaded and the previous
+ * one is consumed, so the throughput is the one of the slowest stage instead of the sum of the three.
+ * The buffers are allocated once for all the stream. T is never freed when M is symmetric, because the
+ * slot will be used again
+ * Input:
+ *      test (Test) - The test type used to load the matrices
+ *      n (int) - Size of the matrices
+ *      sublength (int) - Dimension of the submatrix
+ *      stream (int) - Number of matrices of the stream
+ *      slots (int) - Number of buffers of the ring (2 is double buffering)
+ * Output: double - Time elapsed from the first load to the last consume
+ */
+double executionPipeline(Test test, int n, int sublength, int stream, int slots) {
+    Pipeline pipe={.test=test, .n=n, .sublength=sublength, .slots=slots, .stream=stream, .checksum=0.0, .produced=0, .transposed=0, .consumed=0};
+    pipe.M=malloc(sizeof(float**)*slots);
+    pipe.T=malloc(sizeof(float**)*slots);
+    pipe.symmetric=malloc(sizeof(bool)*slots);
+    if(pipe.M==NULL || pipe.T==NULL || pipe.symmetric==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    for (int k=0; k<slots; k++) {
+        pipe.M[k]=allocateMatrixPerMode(PIPE_BB, n);
+        pipe.T[k]=allocateMatrixPerMode(PIPE_BB, n);
+    }
+    pthread_mutex_init(&pipe.lock, NULL);
+    pthread_cond_init(&pipe.changed, NULL);
+    double time=0.0;
+    #ifdef _OPENMP
+    double start=omp_get_wtime();
+    pthread_t producer, consumer;
+    if(pthread_create(&producer, NULL, pipelineProducer, &pipe)!=0 || pthread_create(&consumer, NULL, pipelineConsumer, &pipe)!=0) {
+        fprintf(stderr, "Couldn't create the pipeline threads\n");
+        exit(1);
+    }
+    for (long item=0; item<stream; item++) {
+        pthread_mutex_lock(&pipe.lock);
+        while(pipe.produced<=item) {
+            pthread_cond_wait(&pipe.changed, &pipe.lock);
+        }
+        pthread_mutex_unlock(&pipe.lock);
+        const int slot=item%slots;
+        pipe.symmetric[slot]=checkSymOMPGlobal(pipe.M[slot], n);
+        if(!pipe.symmetric[slot]) {
+            matTransposeOMPBlockingBased(pipe.M[slot], pipe.T[slot], n, sublength);
+        }
+        pthread_mutex_lock(&pipe.lock);
+        pipe.transposed++;
+        pthread_cond_broadcast(&pipe.changed);
+        pthread_mutex_unlock(&pipe.lock);
+    }
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    time=omp_get_wtime()-start;
+    #endif
+    pthread_mutex_destroy(&pipe.lock);
+    pthread_cond_destroy(&pipe.changed);
+    for (int k=0; k<slots; k++) {
+        freeMatrixPerMode(PIPE_BB, pipe.M[k], n);
+        freeMatrixPerMode(PIPE_BB, pipe.T[k], n);
+    }
+    free(pipe.M);
+    free(pipe.T);
+    free(pipe.symmetric);
+    return time;
+}
+/*
+ * Name: executionSamplePipeline
+ * One sample of the pipeline mode: a stream of PIPELINESTREAM matrices in a ring of PIPELINESLOTS
+ * buffers. The time of the sample is the sustained time per matrix (total time/matrices)
+ *   Input:
+ *      test (Test) - The test type used to load the matrices
+ *      n (int) - Size of the matrices
+ *      sublength (int) - Dimension of the submatrix
+ * Output: double - Time per matrix
+ */
+double executionSamplePipeline(Test test, int n, int sublength) {
+    double total=executionPipeline(test, n, sublength, PIPELINESTREAM, PIPELINESLOTS);
+    printf("Time Elapsed (get time)=%.12f for %d matrices\n", total, PIPELINESTREAM);
+    return total/PIPELINESTREAM;
+}
+/*
+ * Name: getDefaultThreadPool
+ * Returns the pool created by threadInit for the pthreads mode (NULL in the other modes)
+ * Output: ThreadPool* - The pool
+ */
+ThreadPool* getDefaultThreadPool(void) {
+    return defaultPool;
+}
+/*
+ * Name: threadPoolWork
+ * Work of a worker on the current job. It takes the tiles of its range until they end and then it
+ * steals from the ranges of the others, starting from the next worker. The owner and the thieves use
+ * the same fetch and add on next, so a tile is taken by only one of them without locks and an index
+ * beyond end just means that the range is empty
+ * Input:
+ *      pool (ThreadPool*) - The pool
+ *      id (int) - Index of the worker
+ * Output: none
+ */
+static void threadPoolWork(ThreadPool* pool, int id) {
+    for (int v=0; v<pool->num_threads; v++) {
+        TileRange* range=&pool->ranges[(id+v)%pool->num_threads];
+        long tile;
+        while((tile=atomic_fetch_add_explicit(&range->next, 1, memory_order_relaxed))<range->end) {
+            TRACE_START(begin);
+            pool->function(tile, id, pool->arg);
+            TRACE_STOP(v==0 ? "tile" : "stolenTile", tile, begin);
+        }
+    }
+}
+/*
+ * Name: pinThread
+ * Pin a thread on a CPU with pthread_setaffinity_np
+ * Input:
+ *      thread (pthread_t) - Thread to pin
+ *      cpu (int) - CPU (if negative nothing is done)
+ * Output: none
+ */
+static void pinThread(pthread_t thread, int cpu) {
+    if(cpu>=0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if(pthread_setaffinity_np(thread, sizeof(cpu_set_t), &set)!=0) {
+            fprintf(stderr, "Couldn't pin thread on CPU %d\n", cpu);
+        }
+    }
+}
+/*
+ * Name: pinCurrentThread
+ * Pin the calling thread on a CPU with sched_setaffinity (used by the OMP threads, which don't expose
+ * their pthread_t)
+ * Input: cpu (int) - CPU (if negative nothing is done)
+ * Output: none
+ */
+void pinCurrentThread(int cpu) {
+    if(cpu>=0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if(sched_setaffinity(0, sizeof(cpu_set_t), &set)!=0) {
+            fprintf(stderr, "Couldn't pin thread on CPU %d\n", cpu);
+        }
+    }
+}
+/*
+ * Name: readTopology
+ * Read from sysfs the socket and the physical core of a CPU. If the files are not present (not Linux
+ * or no permissions) each CPU is considered a core of the socket 0
+ * Input: cpu (int) - CPU
+ * Output: CPUInfo - CPU, socket and core
+ */
+static CPUInfo readTopology(int cpu) {
+    CPUInfo info={.cpu=cpu, .socket=0, .core=cpu};
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+    FILE* file=fopen(path, "r");
+    if(file!=NULL) {
+        if(fscanf(file, "%d", &info.socket)!=1) {
+            info.socket=0;
+        }
+        fclose(file);
+    }
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+    file=fopen(path, "r");
+    if(file!=NULL) {
+        if(fscanf(file, "%d", &info.core)!=1) {
+            info.core=cpu;
+        }
+        fclose(file);
+    }
+    return info;
+}
+/*
+ * Name: compareCPUInfo
+ * Order of the CPUs for qsort: socket, physical core and then CPU (the siblings of a core are adjacent)
+ */
+static int compareCPUInfo(const void* a, const void* b) {
+    const CPUInfo* x=a;
+    const CPUInfo* y=b;
+    if(x->socket!=y->socket) {
+        return x->socket-y->socket;
+    }
+    if(x->core!=y->core) {
+        return x->core-y->core;
+    }
+    return x->cpu-y->cpu;
+}
+/*
+ * Name: getPlacement
+ * Map each thread on a CPU according to a policy, considering only the CPUs the process is allowed to
+ * use (so it works inside the cpuset given by PBS). The policies are:
+ *      compact - Fill a socket before passing to the next one, siblings of a core are adjacent
+ *      cores - One thread per physical core, filling the sockets in order
+ *      spread - One thread per physical core, alternating the sockets (thread i on socket i%sockets)
+ *      CPU list - Explicit list like 0,2,8-11 (thread i on the i-th CPU of the list), every CPU has to be allowed
+ * If the threads are more than the CPUs of the policy the list starts again from the beginning
+ * Input:
+ *      policy (const char*) - The policy (NULL means no placement)
+ *      num_threads (int) - Number of threads to place
+ * Output: int* - CPU of each thread (num_threads values allocated in heap) or NULL without policy
+ */
+int* getPlacement(const char* policy, int num_threads) {
+    if(policy==NULL || policy[0]=='\0') {
+        return NULL;
+    }
+    int* cpus=malloc(sizeof(int)*num_threads);
+    CPUInfo* infos=malloc(sizeof(CPUInfo)*CPU_SETSIZE);
+    int* order=malloc(sizeof(int)*CPU_SETSIZE);
+    if(cpus==NULL || infos==NULL || order==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(cpu_set_t), &allowed)!=0) {
+        fprintf(stderr, "Couldn't read the CPUs of the process\n");
+        exit(1);
+    }
+    int count=0;
+    if(policy[0]>='0' && policy[0]<='9') {
+        const char* c=policy;
+        while(*c!='\0') {
+            char* end;
+            long first=strtol(c, &end, 10);
+            long last=first;
+            if(*end=='-') {
+                last=strtol(end+1, &end, 10);
+            }
+            if(end==c || first<0 || last<first || last>=CPU_SETSIZE || (*end!=',' && *end!='\0')) {
+                fprintf(stderr, "Invalid CPU list %s in %s\n", policy, PLACESVARIABLE);
+                exit(1);
+            }
+            for (long cpu=first; cpu<=last && count<CPU_SETSIZE; cpu++) {
+                if(!CPU_ISSET(cpu, &allowed)) {
+                    fprintf(stderr, "CPU %ld of %s is not allowed to the process (taskset, cpuset of PBS)\n", cpu, PLACESVARIABLE);
+                    exit(1);
+                }
+                order[count++]=(int)cpu;
+            }
+            c=(*end==',') ? end+1 : end;
+        }
+    }
+    else {
+        int available=0;
+        for (int cpu=0; cpu<CPU_SETSIZE; cpu++) {
+            if(CPU_ISSET(cpu, &allowed)) {
+                infos[available++]=readTopology(cpu);
+            }
+        }
+        qsort(infos, available, sizeof(CPUInfo), compareCPUInfo);
+        if(strcmp(policy, "compact")==0) {
+            for (int i=0; i<available; i++) {
+                order[count++]=infos[i].cpu;
+            }
+        }
+        else if(strcmp(policy, "cores")==0 || strcmp(policy, "spread")==0) {
+            //First CPU of each physical core, already ordered by socket
+            int cores=0;
+            for (int i=0; i<available; i++) {
+                if(i==0 || infos[i].socket!=infos[cores-1].socket || infos[i].core!=infos[cores-1].core) {
+                    infos[cores++]=infos[i];
+                }
+            }
+            if(strcmp(policy, "cores")==0) {
+                for (int i=0; i<cores; i++) {
+                    order[count++]=infos[i].cpu;
+                }
+            }
+            else {
+                //Round robin on the sockets, each taking its next core
+                int* next=malloc(sizeof(int)*(cores+1));
+                if(next==NULL) {
+                    fprintf(stderr, "ERROR Memory Allocation");
+                    exit(1);
+                }
+                int sockets=0;
+                for (int i=0; i<cores; i++) {
+                    if(i==0 || infos[i].socket!=infos[i-1].socket) {
+                        next[sockets++]=i;
+                    }
+                }
+                next[sockets]=cores;
+                int* first=malloc(sizeof(int)*(sockets+1));
+                if(first==NULL) {
+                    fprintf(stderr, "ERROR Memory Allocation");
+                    exit(1);
+                }
+                memcpy(first, next, sizeof(int)*(sockets+1));
+                while(count<cores) {
+                    for (int k=0; k<sockets; k++) {
+                        if(next[k]<first[k+1]) {
+                            order[count++]=infos[next[k]++].cpu;
+                        }
+                    }
+                }
+                free(first);
+                free(next);
+            }
+        }
+        else {
+            fprintf(stderr, "Invalid placement %s in %s, it has to be compact, cores, spread or a CPU list (0,2,4-7)\n", policy, PLACESVARIABLE);
+            exit(1);
+        }
+    }
+    if(count==0) {
+        fprintf(stderr, "No CPU available for the placement %s\n", policy);
+        exit(1);
+    }
+    for (int i=0; i<num_threads; i++) {
+        cpus[i]=order[i%count];
+    }
+    free(infos);
+    free(order);
+    return cpus;
+}
+/*
+ * Name: printThreadPlacement
+ * Print where a thread can actually run, reading back its affinity, so the placement is verified and
+ * not only requested. If the thread is pinned on one CPU also its socket and core are printed
+ * Input:
+ *      thread (int) - Index of the thread
+ *      num_threads (int) - Number of threads
+ *      handle (pthread_t) - The thread
+ * Output: none
+ */
+void printThreadPlacement(int thread, int num_threads, pthread_t handle) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(pthread_getaffinity_np(handle, sizeof(cpu_set_t), &set)!=0) {
+        printf("Thread %d out of %d threads\n", thread, num_threads);
+        return;
+    }
+    if(CPU_COUNT(&set)==1) {
+        int cpu=0;
+        while(!CPU_ISSET(cpu, &set)) {
+            cpu++;
+        }
+        CPUInfo info=readTopology(cpu);
+        printf("Thread %d out of %d threads on CPU %d (socket %d, core %d)\n", thread, num_threads, cpu, info.socket, info.core);
+    }
+    else {
+        printf("Thread %d out of %d threads not pinned (%d CPUs allowed)\n", thread, num_threads, CPU_COUNT(&set));
+    }
+}
+/*
+ * Name: traceInit
+ * Enables the tracer if TRANSPOSE_TRACE is set, it has to be called before starting the threads to trace
+ * Output: none
+ */
+void traceInit(void) {
+    if(getenv(TRACEVARIABLE)==NULL || getenv(TRACEVARIABLE)[0]=='\0') {
+        return;
+    }
+    atomic_init(&traceThreads, 0);
+    traceOrigin=traceNow();
+    traceEnabled=true;
+}
+/*
+ * Name: traceNow
+ * Time of the events, monotonic and comparable between the threads
+ * Output: uint64_t - ns
+ */
+uint64_t traceNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec*1000000000ull+(uint64_t)now.tv_nsec;
+}
+/*
+ * Name: traceRecord
+ * Records an event that started at begin and ends now in the ring of the calling thread. The ring is
+ * taken (and allocated, so on the NUMA node of the thread) at its first event, then no locks are used
+ * Input:
+ *      name (const char*) - Name of the phase or of the tile (a string literal, only the pointer is kept)
+ *      tile (long) - Index of the tile, -1 for a phase
+ *      begin (uint64_t) - Start given by TRACE_START
+ * Output: none
+ */
+void traceRecord(const char* name, long tile, uint64_t begin) {
+    const uint64_t end=traceNow();
+    if(traceThread==-1) {
+        traceThread=atomic_fetch_add(&traceThreads, 1);
+        if(traceThread>=TRACETHREADS) {
+            traceThread=-2;
+        }
+        else {
+            TraceBuffer* buffer=&traceBuffers[traceThread];
+            buffer->events=malloc(sizeof(TraceEvent)*TRACECAPACITY);
+            buffer->count=0;
+            buffer->cpu=sched_getcpu();
+            if(buffer->events==NULL) {
+                traceThread=-2;
+            }
+        }
+    }
+    if(traceThread<0) {
+        return;
+    }
+    TraceBuffer* buffer=&traceBuffers[traceThread];
+    buffer->events[buffer->count%TRACECAPACITY]=(TraceEvent){.name=name, .tile=tile, .begin=begin, .end=end};
+    buffer->count++;
+}
+/*
+ * Name: traceWrite
+ * Writes the events of all the rings in TRANSPOSE_TRACE as complete events ("ph":"X"), one row per thread named
+ * with its CPU and socket and sorted by CPU, so the threads of a socket are near. With MPI each rank writes
+ * <file>.<rank>. It has to be called when the traced threads aren't working anymore
+ * Output: none
+ */
+void traceWrite(void) {
+    if(!traceEnabled) {
+        return;
+    }
+    char path[1024];
+    const int rank=getRank();
+    if(rank==0) {
+        snprintf(path, sizeof(path), "%s", getenv(TRACEVARIABLE));
+    }
+    else {
+        snprintf(path, sizeof(path), "%s.%d", getenv(TRACEVARIABLE), rank);
+    }
+    FILE* file=fopen(path, "w");
+    if(file==NULL) {
+        fprintf(stderr, "Couldn't open or create %s\n", path);
+        return;
+    }
+    const int threads=MIN(atomic_load(&traceThreads), TRACETHREADS);
+    long events=0, lost=0;
+    bool first=true;
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for (int t=0; t<threads; t++) {
+        const TraceBuffer* buffer=&traceBuffers[t];
+        if(buffer->events==NULL) {
+            continue;
+        }
+        CPUInfo info=readTopology(MAX(buffer->cpu, 0));
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"Thread %d (CPU %d, socket %d)\"}},\n", first ? "" : ",",
+                rank, t, t, buffer->cpu, info.socket);
+        fprintf(file, "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"sort_index\":%d}}", rank, t, buffer->cpu);
+        first=false;
+        const long start=MAX(buffer->count-TRACECAPACITY, 0);
+        lost+=start;
+        for (long k=start; k<buffer->count; k++) {
+            const TraceEvent* event=&buffer->events[k%TRACECAPACITY];
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f", event->name, rank, t,
+                    (event->begin-traceOrigin)/1000.0, (event->end-event->begin)/1000.0);
+            if(event->tile>=0) {
+                fprintf(file, ",\"args\":{\"tile\":%ld}", event->tile);
+            }
+            fprintf(file, "}");
+            events++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    printf("Trace written in %s: %ld events of %d threads (%ld older overwritten)\n", path, events, threads, lost);
+}
+typedef struct {
+    ThreadPool* pool;
+    int id;
+} WorkerArgs;
+/*
+ * Name: threadPoolWorker
+ * Body of the workers of the pool: wait for a new generation, do the job and notify the end
+ * Input: arg (void*) - WorkerArgs of the thread (freed by the worker)
+ * Output: void* - NULL
+ */
+static void* threadPoolWorker(void* arg) {
+    ThreadPool* pool=((WorkerArgs*)arg)->pool;
+    int id=((WorkerArgs*)arg)->id;
+    free(arg);
+    long seen=0;
+    while(true) {
+        pthread_mutex_lock(&pool->lock);
+        while(pool->generation==seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if(pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen=pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+        threadPoolWork(pool, id);
+        pthread_mutex_lock(&pool->lock);
+        pool->running--;
+        if(pool->running==0) {
+            pthread_cond_signal(&pool->done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+/*
+ * Name: threadPoolCreate
+ * Create a persistent pool of threads, alternative to the OMP runtime, so the behaviour doesn't
+ * depend on the OMP_* variables of the environment. The caller is the worker 0, so num_threads-1
+ * threads are created. Each worker is pinned on a CPU, if cpus is NULL they are pinned in order on
+ * the CPUs that the process is allowed to use
+ * Input:
+ *      num_threads (int) - Number of workers (caller included)
+ *      cpus (const int*) - CPU of each worker (num_threads values, -1 not pinned) or NULL
+ * Output: ThreadPool* - The pool, to be destroyed with threadPoolDestroy
+ */
+ThreadPool* threadPoolCreate(int num_threads, const int* cpus) {
+    ThreadPool* pool=malloc(sizeof(ThreadPool));
+    if(pool==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    pool->num_threads=num_threads;
+    pool->threads=malloc(sizeof(pthread_t)*num_threads);
+    pool->cpus=malloc(sizeof(int)*num_threads);
+    pool->ranges=aligned_alloc(CACHELINE, sizeof(TileRange)*num_threads);
+    if(pool->threads==NULL || pool->cpus==NULL || pool->ranges==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    if(cpus!=NULL) {
+        memcpy(pool->cpus, cpus, sizeof(int)*num_threads);
+    }
+    else {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        sched_getaffinity(0, sizeof(cpu_set_t), &allowed);
+        int cpu=0;
+        for (int i=0; i<num_threads; i++) {
+            if(CPU_COUNT(&allowed)==0) {
+                pool->cpus[i]=-1;
+                continue;
+            }
+            while(!CPU_ISSET(cpu%CPU_SETSIZE, &allowed)) {
+                cpu=(cpu+1)%CPU_SETSIZE;
+            }
+            pool->cpus[i]=cpu;
+            cpu=(cpu+1)%CPU_SETSIZE;
+        }
+    }
+    for (int i=0; i<num_threads; i++) {
+        atomic_init(&pool->ranges[i].next, 0);
+        pool->ranges[i].end=0;
+    }
+    pool->function=NULL;
+    pool->arg=NULL;
+    pool->generation=0;
+    pool->running=0;
+    pool->shutdown=false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pinThread(pthread_self(), pool->cpus[0]);
+    for (int i=1; i<num_threads; i++) {
+        WorkerArgs* args=malloc(sizeof(WorkerArgs));
+        if(args==NULL) {
+            fprintf(stderr, "ERROR Memory Allocation");
+            exit(1);
+        }
+        args->pool=pool;
+        args->id=i;
+        //The affinity is set before the thread starts, so when threadPoolCreate returns every worker is
+        //already on its CPU (and its first touches happen there)
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if(pool->cpus[i]>=0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(pool->cpus[i], &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+        }
+        if(pthread_create(&pool->threads[i], &attr, threadPoolWorker, args)!=0) {
+            fprintf(stderr, "Couldn't create thread %d on CPU %d\n", i, pool->cpus[i]);
+            exit(1);
+        }
+        pthread_attr_destroy(&attr);
+    }
+    return pool;
+}
+/*
+ * Name: threadPoolRun
+ * Execute a job of tiles on the pool and return when all the tiles are done. The tiles [0, tiles)
+ * are split in contiguous ranges, one per worker (like schedule(static)), and the workers that end
+ * their range steal the tiles of the others
+ * Input:
+ *      pool (ThreadPool*) - The pool
+ *      tiles (long) - Number of tiles of the job
+ *      function (TileFunction) - Function called on each tile
+ *      arg (void*) - Argument passed to the function
+ * Output: none
+ */
+void threadPoolRun(ThreadPool* pool, long tiles, TileFunction function, void* arg) {
+    const int p=pool->num_threads;
+    for (int i=0; i<p; i++) {
+        atomic_store_explicit(&pool->ranges[i].next, tiles*i/p, memory_order_relaxed);
+        pool->ranges[i].end=tiles*(i+1)/p;
+    }
+    pool->function=function;
+    pool->arg=arg;
+    pthread_mutex_lock(&pool->lock);
+    pool->running=p-1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    threadPoolWork(pool, 0);
+    pthread_mutex_lock(&pool->lock);
+    while(pool->running>0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+/*
+ * Name: threadPoolDestroy
+ * Stop and join the workers and free the pool
+ * Input: pool (ThreadPool*) - The pool (can be NULL)
+ * Output: none
+ */
+void threadPoolDestroy(ThreadPool* pool) {
+    if(pool==NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown=true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i=1; i<pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    if(pool==defaultPool) {
+        defaultPool=NULL;
+    }
+    free(pool->threads);
+    free(pool->cpus);
+    free(pool->ranges);
+    free(pool);
+}
+typedef struct {
+    float** M;
+    float** T;
+    int size;
+    int sublength;
+    int blocks;
+    atomic_bool symmetric;
+} PthreadsJob;
+/*
+ * Name: lowerTriangleRow
+ * Row bi of the pair of blocks (bi, bj) with bj<=bi that is the tile-th of the lower triangle in
+ * row-major order (bj is tile-bi*(bi+1)/2). The square root is corrected for the rounding
+ */
+static long lowerTriangleRow(long tile) {
+    long bi=(long)((sqrt(8.0*tile+1)-1)/2);
+    while(bi*(bi+1)/2>tile) {
+        bi--;
+    }
+    while((bi+1)*(bi+2)/2<=tile) {
+        bi++;
+    }
+    return bi;
+}
+/*
+ * Name: checkSymTilePthreads
+ * Tile of checkSymPthreads, the tile index is mapped on the pair of blocks (bi, bj) of the lower
+ * triangle with bj<=bi. When a thread finds a different pair, the others skip their remaining tiles
+ * (cooperative cancel without OMP_CANCELLATION)
+ */
+static void checkSymTilePthreads(long tile, int thread, void* arg) {
+    (void)thread;
+    PthreadsJob* job=arg;
+    if(!atomic_load_explicit(&job->symmetric, memory_order_relaxed)) {
+        return;
+    }
+    long bi=lowerTriangleRow(tile);
+    long bj=tile-bi*(bi+1)/2;
+    if(!checkSymTile(job->M, job->size, (int)bi*job->sublength, (int)bj*job->sublength, job->sublength)) {
+        atomic_store_explicit(&job->symmetric, false, memory_order_relaxed);
+    }
+}
+/*
+ * Name: checkSymPthreads
+ * See checkSymImpStandard - The blocks of the lower triangle are the tiles of a job on the pool.
+ * The triangular shape gives more work to the last rows, but the stealing rebalances it
+ * Input:
+ *      pool (ThreadPool*) - The pool
+ *      M (float**) - The allocated in heap matrix
+ *      size (int) - Dimension of the side of the squared matrix
+ *      sublength (int) - Blocks of a submatrix
+ * Output: bool (true - Matrix is symmetric; false - The matrix doesn't concide
+ * with its transpose
+ */
+bool checkSymPthreads(ThreadPool* pool, float** M, int size, int sublength) {
+    PthreadsJob job={.M=M, .T=NULL, .size=size, .sublength=sublength, .blocks=(size+sublength-1)/sublength};
+    atomic_init(&job.symmetric, true);
+    threadPoolRun(pool, (long)job.blocks*(job.blocks+1)/2, checkSymTilePthreads, &job);
+    return atomic_load(&job.symmetric);
+}
+/*
+ * Name: matTransposeTilePthreads
+ * Tile of matTransposePthreads, the tile index is the block (bi, bj) of T in row-major order
+ */
+static void matTransposeTilePthreads(long tile, int thread, void* arg) {
+    (void)thread;
+    PthreadsJob* job=arg;
+    int i=(int)(tile/job->blocks)*job->sublength;
+    int j=(int)(tile%job->blocks)*job->sublength;
+    matTransposeTile(job->M, job->T, j, i, i, j, MIN(job->sublength, job->size-j), MIN(job->sublength, job->size-i), job->sublength);
+}
+/*
+ * Name: matTransposePthreads
+ * See matTransposeOMPBlockingBased - Same blocks, given to the pool instead of collapse(2) schedule(static)
+ * Input:
+ *      pool (ThreadPool*) - The pool
+ *      M (float**) - The start allocated in heap matrix
+ *      T (float**) - The destination allocated in heap matrix (has to be allocated outside)
+ *      size (int) - Dimension of the matrix
+ *      sublength (int) - Dimension of the submatrix
+ * Output: none
+ */
+void matTransposePthreads(ThreadPool* pool, float** M, float** T, int size, int sublength) {
+    PthreadsJob job={.M=M, .T=T, .size=size, .sublength=sublength, .blocks=(size+sublength-1)/sublength};
+    atomic_init(&job.symmetric, true);
+    threadPoolRun(pool, (long)job.blocks*job.blocks, matTransposeTilePthreads, &job);
+}
+/*
+ * Name: asyncCheckTile
+ * Tile of the check of an asynchronous job, see checkSymTilePthreads. A cancelled job skips the
+ * remaining tiles, the ones skipped after a different pair are counted as done
+ */
+static void asyncCheckTile(long tile, int thread, void* arg) {
+    (void)thread;
+    AsyncJob* job=arg;
+    if(atomic_load_explicit(&job->cancel, memory_order_relaxed)) {
+        return;
+    }
+    if(atomic_load_explicit(&job->symmetric, memory_order_relaxed)) {
+        long bi=lowerTriangleRow(tile);
+        long bj=tile-bi*(bi+1)/2;
+        if(!checkSymTile(job->M, job->size, (int)bi*job->sublength, (int)bj*job->sublength, job->sublength)) {
+            atomic_store_explicit(&job->symmetric, false, memory_order_relaxed);
+        }
+    }
+    atomic_fetch_add_explicit(&job->tiles_done, 1, memory_order_relaxed);
+}
+/*
+ * Name: asyncTransposeTile
+ * Tile of the transposition of an asynchronous job, see matTransposeTilePthreads
+ */
+static void asyncTransposeTile(long tile, int thread, void* arg) {
+    (void)thread;
+    AsyncJob* job=arg;
+    if(atomic_load_explicit(&job->cancel, memory_order_relaxed)) {
+        return;
+    }
+    int i=(int)(tile/job->blocks)*job->sublength;
+    int j=(int)(tile%job->blocks)*job->sublength;
+    matTransposeTile(job->M, job->T, j, i, i, j, MIN(job->sublength, job->size-j), MIN(job->sublength, job->size-i), job->sublength);
+    atomic_fetch_add_explicit(&job->tiles_done, 1, memory_order_relaxed);
+}
+/*
+ * Name: asyncFinish
+ * Sets the final state of a job and wakes who is waiting it
+ */
+static void asyncFinish(AsyncJob* job, AsyncState state) {
+    pthread_mutex_lock(&job->lock);
+    if(state==ASYNC_DONE) {
+        atomic_store(&job->tiles_done, job->tiles);
+    }
+    atomic_store(&job->state, state);
+    pthread_cond_broadcast(&job->finished);
+    pthread_mutex_unlock(&job->lock);
+}
+/*
+ * Name: asyncDispatcher
+ * Thread of the executor: creates the pool (so it is the worker 0, pinned on the first CPU) and
+ * executes the queued jobs one at a time with all the workers, until asyncDestroy
+ * Input: arg (void*) - The AsyncExecutor
+ * Output: void* - NULL
+ */
+static void* asyncDispatcher(void* arg) {
+    AsyncExecutor* executor=arg;
+    executor->pool=threadPoolCreate(executor->num_threads, executor->cpus);
+    while(true) {
+        pthread_mutex_lock(&executor->lock);
+        while(executor->head==NULL && !executor->shutdown) {
+            pthread_cond_wait(&executor->queued, &executor->lock);
+        }
+        AsyncJob* job=executor->head;
+        if(job==NULL) {
+            pthread_mutex_unlock(&executor->lock);
+            break;
+        }
+        executor->head=job->next;
+        if(executor->head==NULL) {
+            executor->tail=NULL;
+        }
+        executor->current=job;
+        pthread_mutex_unlock(&executor->lock);
+        //Cancelled before starting: nothing to do
+        if(atomic_load(&job->cancel)) {
+            asyncFinish(job, ASYNC_CANCELLED);
+            continue;
+        }
+        atomic_store(&job->state, ASYNC_RUNNING);
+        threadPoolRun(executor->pool, (long)job->blocks*(job->blocks+1)/2, asyncCheckTile, job);
+        if(!atomic_load(&job->cancel) && !atomic_load(&job->symmetric)) {
+            threadPoolRun(executor->pool, (long)job->blocks*job->blocks, asyncTransposeTile, job);
+        }
+        pthread_mutex_lock(&executor->lock);
+        executor->current=NULL;
+        pthread_mutex_unlock(&executor->lock);
+        asyncFinish(job, atomic_load(&job->cancel) ? ASYNC_CANCELLED : ASYNC_DONE);
+    }
+    threadPoolDestroy(executor->pool);
+    return NULL;
+}
+/*
+ * Name: asyncCreate
+ * Creates an executor of asynchronous jobs: a dispatcher thread with its pool of num_threads workers
+ * (the dispatcher included), so the caller is never used to do the tiles
+ * Input:
+ *      num_threads (int) - Number of workers of the pool
+ *      cpus (const int*) - CPU of each worker (see threadPoolCreate) or NULL
+ * Output: AsyncExecutor* - The executor, to be destroyed with asyncDestroy
+ */
+AsyncExecutor* asyncCreate(int num_threads, const int* cpus) {
+    AsyncExecutor* executor=malloc(sizeof(AsyncExecutor));
+    if(executor==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    executor->pool=NULL;
+    executor->num_threads=num_threads;
+    executor->cpus=NULL;
+    if(cpus!=NULL) {
+        executor->cpus=malloc(sizeof(int)*num_threads);
+        if(executor->cpus==NULL) {
+            fprintf(stderr, "ERROR Memory Allocation");
+            exit(1);
+        }
+        memcpy(executor->cpus, cpus, sizeof(int)*num_threads);
+    }
+    executor->head=NULL;
+    executor->tail=NULL;
+    executor->current=NULL;
+    executor->shutdown=false;
+    pthread_mutex_init(&executor->lock, NULL);
+    pthread_cond_init(&executor->queued, NULL);
+    if(pthread_create(&executor->dispatcher, NULL, asyncDispatcher, executor)!=0) {
+        fprintf(stderr, "Couldn't create the dispatcher thread\n");
+        exit(1);
+    }
+    return executor;
+}
+/*
+ * Name: asyncSubmit
+ * Queues the check of M and, if it isn't symmetric, its transposition in T (as executionProgram) and
+ * returns immediately. The matrices have to stay allocated until the job is finished
+ * Input:
+ *      executor (AsyncExecutor*) - The executor
+ *      M (float**) - The allocated in heap matrix
+ *      T (float**) - The destination allocated in heap matrix
+ *      size (int) - Dimension of the side of the squared matrix
+ *      sublength (int) - Dimension of the submatrix (0 for MAXIMUMSUBLENGTH)
+ * Output: AsyncJob* - The handle, to be released with asyncRelease
+ */
+AsyncJob* asyncSubmit(AsyncExecutor* executor, float** M, float** T, int size, int sublength) {
+    AsyncJob* job=malloc(sizeof(AsyncJob));
+    if(job==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    job->M=M;
+    job->T=T;
+    job->size=size;
+    job->sublength=(sublength>0) ? sublength : MAXIMUMSUBLENGTH;
+    job->blocks=(size+job->sublength-1)/job->sublength;
+    job->tiles=(long)job->blocks*(job->blocks+1)/2+(long)job->blocks*job->blocks;
+    atomic_init(&job->tiles_done, 0);
+    atomic_init(&job->state, ASYNC_QUEUED);
+    atomic_init(&job->cancel, false);
+    atomic_init(&job->symmetric, true);
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_cond_init(&job->finished, NULL);
+    job->next=NULL;
+    pthread_mutex_lock(&executor->lock);
+    if(executor->tail!=NULL) {
+        executor->tail->next=job;
+    }
+    else {
+        executor->head=job;
+    }
+    executor->tail=job;
+    pthread_cond_signal(&executor->queued);
+    pthread_mutex_unlock(&executor->lock);
+    return job;
+}
+/*
+ * Name: asyncPoll
+ * State of a job, without waiting
+ * Input: job (AsyncJob*) - The handle
+ * Output: AsyncState - ASYNC_QUEUED, ASYNC_RUNNING, ASYNC_DONE or ASYNC_CANCELLED
+ */
+AsyncState asyncPoll(AsyncJob* job) {
+    return (AsyncState)atomic_load(&job->state);
+}
+/*
+ * Name: asyncWait
+ * Waits the end of a job
+ * Input: job (AsyncJob*) - The handle
+ * Output: AsyncState - ASYNC_DONE or ASYNC_CANCELLED
+ */
+AsyncState asyncWait(AsyncJob* job) {
+    pthread_mutex_lock(&job->lock);
+    while(atomic_load(&job->state)<ASYNC_DONE) {
+        pthread_cond_wait(&job->finished, &job->lock);
+    }
+    pthread_mutex_unlock(&job->lock);
+    return (AsyncState)atomic_load(&job->state);
+}
+/*
+ * Name: asyncProgress
+ * Fraction of the tiles of the job done up to now. The tiles of the transposition are counted even if
+ * the matrix turns out symmetric, so it goes to 1 only at the end
+ * Input: job (AsyncJob*) - The handle
+ * Output: double - Between 0 and 1
+ */
+double asyncProgress(AsyncJob* job) {
+    if(job->tiles==0) {
+        return (atomic_load(&job->state)==ASYNC_DONE) ? 1.0 : 0.0;
+    }
+    return (double)atomic_load_explicit(&job->tiles_done, memory_order_relaxed)/job->tiles;
+}
+/*
+ * Name: asyncCancel
+ * Asks to stop a job: a queued one is never started, a running one stops at the end of the tiles in
+ * execution, so T is left partially written. It doesn't wait, asyncWait gives ASYNC_CANCELLED if the
+ * request arrived before the end
+ * Input: job (AsyncJob*) - The handle
+ * Output: none
+ */
+void asyncCancel(AsyncJob* job) {
+    atomic_store(&job->cancel, true);
+}
+/*
+ * Name: asyncSymmetric
+ * Result of the check of a job ended with ASYNC_DONE (if true T wasn't written)
+ * Input: job (AsyncJob*) - The handle
+ * Output: bool - true if M is symmetric
+ */
+bool asyncSymmetric(AsyncJob* job) {
+    return atomic_load(&job->symmetric);
+}
+/*
+ * Name: asyncRelease
+ * Frees a handle. A job not finished yet is cancelled and waited, so a stale job can be abandoned
+ * just releasing it
+ * Input: job (AsyncJob*) - The handle (can be NULL)
+ * Output: none
+ */
+void asyncRelease(AsyncJob* job) {
+    if(job==NULL) {
+        return;
+    }
+    //Waited even if already finished, so the dispatcher has left the lock of the job
+    if(asyncPoll(job)<ASYNC_DONE) {
+        asyncCancel(job);
+    }
+    asyncWait(job);
+    pthread_mutex_destroy(&job->lock);
+    pthread_cond_destroy(&job->finished);
+    free(job);
+}
+/*
+ * Name: asyncDestroy
+ * Cancels the jobs still queued or running, waits the dispatcher and frees the executor. The
+ * handles stay valid and have to be released with asyncRelease
+ * Input: executor (AsyncExecutor*) - The executor (can be NULL)
+ * Output: none
+ */
+void asyncDestroy(AsyncExecutor* executor) {
+    if(executor==NULL) {
+        return;
+    }
+    pthread_mutex_lock(&executor->lock);
+    for (AsyncJob* job=executor->head; job!=NULL; job=job->next) {
+        asyncCancel(job);
+    }
+    if(executor->current!=NULL) {
+        asyncCancel(executor->current);
+    }
+    executor->shutdown=true;
+    pthread_cond_signal(&executor->queued);
+    pthread_mutex_unlock(&executor->lock);
+    pthread_join(executor->dispatcher, NULL);
+    pthread_mutex_destroy(&executor->lock);
+    pthread_cond_destroy(&executor->queued);
+    free(executor->cpus);
+    free(executor);
+}
+/*
+ * Name: daemonListen
+ * Creates the UNIX socket of the daemon (removing an old one left on the same path) and listens on it
+ * Input: path (const char*) - Path of the socket
+ * Output: int - The listening socket
+ */
+int daemonListen(const char* path) {
+    struct sockaddr_un address={.sun_family=AF_UNIX};
+    if(strlen(path)>=sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path %s too long\n", path);
+        exit(1);
+    }
+    strcpy(address.sun_path, path);
+    int sock=socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+    if(sock<0) {
+        perror("socket");
+        exit(1);
+    }
+    unlink(path);
+    if(bind(sock, (struct sockaddr*)&address, sizeof(address))<0 || listen(sock, DAEMONCLIENTS)<0) {
+        perror(path);
+        exit(1);
+    }
+    return sock;
+}
+/*
+ * Name: daemonConnect
+ * Client side: connects to the socket of the daemon
+ * Input: path (const char*) - Path of the socket
+ * Output: int - The connected socket, -1 if the daemon isn't there
+ */
+int daemonConnect(const char* path) {
+    struct sockaddr_un address={.sun_family=AF_UNIX};
+    if(strlen(path)>=sizeof(address.sun_path)) {
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    int sock=socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+    if(sock<0) {
+        return -1;
+    }
+    if(connect(sock, (struct sockaddr*)&address, sizeof(address))<0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+/*
+ * Name: daemonSend
+ * Client side: sends a request with the memfd that holds M and T as ancillary data (SCM_RIGHTS), so the
+ * daemon maps the same pages and nothing is copied
+ * Input:
+ *      sock (int) - Socket connected to the daemon
+ *      request (const DaemonRequest*) - The request
+ *      fd (int) - The memfd
+ * Output: int - 0 if sent, -1 otherwise
+ */
+int daemonSend(int sock, const DaemonRequest* request, int fd) {
+    struct iovec data={.iov_base=(void*)request, .iov_len=sizeof(*request)};
+    union {
+        char buffer[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct msghdr message={.msg_iov=&data, .msg_iovlen=1, .msg_control=control.buffer, .msg_controllen=sizeof(control.buffer)};
+    struct cmsghdr* header=CMSG_FIRSTHDR(&message);
+    header->cmsg_level=SOL_SOCKET;
+    header->cmsg_type=SCM_RIGHTS;
+    header->cmsg_len=CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(header), &fd, sizeof(int));
+    return sendmsg(sock, &message, MSG_NOSIGNAL)==(ssize_t)sizeof(*request) ? 0 : -1;
+}
+/*
+ * Name: daemonReceive
+ * Daemon side: receives a request and its memfd. The requests are small and sent in a single message,
+ * so a partial one is a broken client
+ * Input:
+ *      sock (int) - Socket of the client (non-blocking)
+ *      request (DaemonRequest*) - Where to write the request
+ *      fd (int*) - Where to write the received memfd (-1 if it was missing)
+ * Output: int - 1 with a request, 0 if there are no more requests now, -1 if the client is closed or broken
+ */
+int daemonReceive(int sock, DaemonRequest* request, int* fd) {
+    struct iovec data={.iov_base=request, .iov_len=sizeof(*request)};
+    union {
+        char buffer[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr message={.msg_iov=&data, .msg_iovlen=1, .msg_control=control.buffer, .msg_controllen=sizeof(control.buffer)};
+    ssize_t received=recvmsg(sock, &message, MSG_CMSG_CLOEXEC);
+    if(received<0 && (errno==EAGAIN || errno==EWOULDBLOCK)) {
+        return 0;
+    }
+    *fd=-1;
+    for (struct cmsghdr* header=CMSG_FIRSTHDR(&message); received>0 && header!=NULL; header=CMSG_NXTHDR(&message, header)) {
+        if(header->cmsg_level==SOL_SOCKET && header->cmsg_type==SCM_RIGHTS) {
+            memcpy(fd, CMSG_DATA(header), sizeof(int));
+        }
+    }
+    if(received!=(ssize_t)sizeof(*request)) {
+        if(*fd>=0) {
+            close(*fd);
+        }
+        return -1;
+    }
+    return 1;
+}
+/*
+ * Name: daemonRows
+ * Pool of the arrays of row pointers of the daemon: slot k keeps its array between the batches and
+ * grows it only when a bigger matrix arrives, so in the steady state a request doesn't allocate
+ * Input:
+ *      slot (int) - Index of the array (two for each job of the batch)
+ *      rows (int) - Number of rows needed
+ * Output: float** - The array
+ */
+static float** daemonRows(int slot, int rows) {
+    static float** arrays[2*DAEMONBATCH];
+    static int capacity[2*DAEMONBATCH];
+    if(capacity[slot]<rows) {
+        float** temp=realloc(arrays[slot], sizeof(float*)*rows);
+        if(temp==NULL) {
+            fprintf(stderr, "ERROR Memory Allocation");
+            exit(1);
+        }
+        arrays[slot]=temp;
+        capacity[slot]=rows;
+    }
+    return arrays[slot];
+}
+/*
+ * Name: daemonMap
+ * Maps the memfd of a job and points the rows of M and T in it, checking that the request is inside the memfd
+ * Input:
+ *      job (DaemonJob*) - The job
+ *      slot (int) - Index of the job in the batch
+ * Output: int - 0 or the errno of the failure
+ */
+static int daemonMap(DaemonJob* job, int slot) {
+    const DaemonRequest* r=&job->request;
+    struct stat info;
+    if(job->fd<0 || fstat(job->fd, &info)<0 || info.st_size<0) {
+        return EBADF;
+    }
+    const uint64_t size=(uint64_t)info.st_size;
+    if(r->type<REQ_TRANSPOSE || r->type>REQ_CHECK_TRANSPOSE || r->rows==0 || r->cols==0 ||
+       (r->type!=REQ_TRANSPOSE && r->rows!=r->cols) || r->sublength>MAXIMUMSUBLENGTH ||
+       r->offset_in%sizeof(float)!=0 || r->offset_out%sizeof(float)!=0 ||
+       (uint64_t)r->rows*r->cols>size/sizeof(float)) {
+        return EINVAL;
+    }
+    //rows*cols fits in the memfd so bytes can't overflow, and the checks below never wrap
+    const uint64_t bytes=(uint64_t)r->rows*r->cols*sizeof(float);
+    if(r->offset_in>size || bytes>size-r->offset_in) {
+        return EINVAL;
+    }
+    if(r->type!=REQ_CHECK) {
+        //The kernels aren't in-place: T overlapping M would read values already overwritten
+        if(r->offset_out>size || bytes>size-r->offset_out ||
+           (r->offset_in<r->offset_out+bytes && r->offset_out<r->offset_in+bytes)) {
+            return EINVAL;
+        }
+    }
+    job->length=info.st_size;
+    job->map=mmap(NULL, job->length, PROT_READ|PROT_WRITE, MAP_SHARED, job->fd, 0);
+    if(job->map==MAP_FAILED) {
+        job->map=NULL;
+        return errno;
+    }
+    job->M=daemonRows(2*slot, r->rows);
+    job->T=daemonRows(2*slot+1, r->cols);
+    for (uint32_t i=0; i<r->rows; i++) {
+        job->M[i]=(float*)((char*)job->map+r->offset_in)+(size_t)i*r->cols;
+    }
+    for (uint32_t i=0; i<r->cols; i++) {
+        job->T[i]=(float*)((char*)job->map+r->offset_out)+(size_t)i*r->rows;
+    }
+    return 0;
+}
+/*
+ * Name: daemonSmallTile
+ * Tile of the batch of the small requests: the tile is a whole request, done by a single thread
+ */
+static void daemonSmallTile(long tile, int thread, void* arg) {
+    (void)thread;
+    DaemonJob* job=((DaemonJob**)arg)[tile];
+    const DaemonRequest* r=&job->request;
+    const int sublength=r->sublength ? (int)r->sublength : MINIMUMSUBLENGTH;
+    bool symmetric=false;
+    if(r->type!=REQ_TRANSPOSE) {
+        symmetric=checkSym(job->M, r->rows);
+    }
+    if(r->type==REQ_TRANSPOSE || (r->type==REQ_CHECK_TRANSPOSE && !symmetric)) {
+        matTransposeTile(job->M, job->T, 0, 0, 0, 0, r->rows, r->cols, sublength);
+    }
+    job->reply.symmetric=symmetric;
+}
+typedef struct {
+    DaemonJob* job;
+    int sublength;
+} DaemonLarge;
+/*
+ * Name: daemonLargeTile
+ * Tile of a big request on all the pool: a band of sublength rows of T
+ */
+static void daemonLargeTile(long tile, int thread, void* arg) {
+    (void)thread;
+    const DaemonLarge* large=arg;
+    const DaemonRequest* r=&large->job->request;
+    const int i=(int)tile*large->sublength;
+    matTransposeTile(large->job->M, large->job->T, 0, i, i, 0, r->rows, MIN(large->sublength, (int)r->cols-i), large->sublength);
+}
+/*
+ * Name: daemonExecute
+ * Executes a batch of requests on the pool of the daemon. The small requests (up to DAEMONSMALL elements)
+ * are done all together, one for each thread, because splitting them would cost more in synchronization
+ * than the work; the big ones, one after the other, with all the threads (checkSymPthreads and bands of
+ * rows of T). The memfds are mapped only for the batch and closed at the end, the replies are left in the jobs
+ * Input:
+ *      pool (ThreadPool*) - The pool of the daemon
+ *      jobs (DaemonJob*) - The requests of the batch
+ *      count (int) - Number of requests (at most DAEMONBATCH)
+ * Output: none
+ */
+void daemonExecute(ThreadPool* pool, DaemonJob* jobs, int count) {
+    DaemonJob* small[DAEMONBATCH];
+    int smalls=0;
+    for (int k=0; k<count; k++) {
+        jobs[k].map=NULL;
+        jobs[k].reply=(DaemonReply){.id=jobs[k].request.id, .status=daemonMap(&jobs[k], k), .symmetric=0};
+        if(jobs[k].reply.status==0 && (uint64_t)jobs[k].request.rows*jobs[k].request.cols<=DAEMONSMALL) {
+            small[smalls++]=&jobs[k];
+        }
+    }
+    if(smalls>0) {
+        threadPoolRun(pool, smalls, daemonSmallTile, small);
+    }
+    for (int k=0; k<count; k++) {
+        DaemonJob* job=&jobs[k];
+        const DaemonRequest* r=&job->request;
+        if(job->reply.status==0 && (uint64_t)r->rows*r->cols>DAEMONSMALL) {
+            DaemonLarge large={.job=job, .sublength=r->sublength ? (int)r->sublength : MAXIMUMSUBLENGTH/pool->num_threads};
+            large.sublength=MAX(large.sublength, MINIMUMSUBLENGTH);
+            bool symmetric=false;
+            if(r->type!=REQ_TRANSPOSE) {
+                symmetric=checkSymPthreads(pool, job->M, r->rows, large.sublength);
+            }
+            if(r->type==REQ_TRANSPOSE || (r->type==REQ_CHECK_TRANSPOSE && !symmetric)) {
+                threadPoolRun(pool, (r->cols+large.sublength-1)/large.sublength, daemonLargeTile, &large);
+            }
+            job->reply.symmetric=symmetric;
+        }
+        if(job->map!=NULL) {
+            munmap(job->map, job->length);
+        }
+        if(job->fd>=0) {
+            close(job->fd);
+        }
+    }
+}
+/*
+ * Name: getRank
+ * Rank of the process in MPI_COMM_WORLD, used to let only the first one print and write the files.
+ * Without MPI (or before MPI_Init) it's always 0
+ * Output: int - rank of the process
+ */
+int getRank(void) {
+    int rank=0;
+    #ifdef USE_MPI
+    int initialized=0;
+    MPI_Initialized(&initialized);
+    if(initialized) {
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    }
+    #endif
+    return rank;
+}
+#ifdef USE_MPI
+/*
+ * Name: executionProgramMPI
+ * Distributed version of executionProgram. The n x n matrix is split in row blocks of n/ranks rows,
+ * rank r holds the rows [r*b, (r+1)*b) of M and will hold the same rows of T. Rank s has in its columns
+ * [r*b, (r+1)*b) the tile that transposed is the block (r, s) of T, so each rank transposes its tiles
+ * with the block kernel directly in the send buffer and the exchange is a blocked all-to-all.
+ * The receives are posted before the local work and the tile for a rank is sent as soon as it is
+ * transposed, so the communication overlaps with the transposition of the next tiles and of the diagonal
+ * one, which doesn't move. Tiles are received with a vector datatype directly in their columns of T.
+ * Checking the symmetry needs M[j][i], which lives on another rank, so the exchange is always done and
+ * the check compares the local rows of M and T, reducing the result on all the ranks
+ *   Input:
+ *      M (float**) - Local row block of M (n/ranks x n), allocated with createFloatMatrixContiguous
+ *      T (float**) - Local row block of T (n/ranks x n), allocated with createFloatMatrixContiguous
+ *      n (int) - Size of the global Matrix
+ *      sublength (int) - Dimension of the submatrix for the local tiles
+ * Output: bool - true if the global matrix is symmetric (T can be discarded), false otherwise
+ */
+bool executionProgramMPI(float** M, float** T, int n, int sublength) {
+    int rank, ranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+    const int b=n/ranks;
+    //Tile for rank r is in the rows [r*b, (r+1)*b) of the send buffer, b*b contiguous floats
+    float** send=createFloatMatrixContiguous(n, b, MINIMUMSUBLENGTH);
+    MPI_Request* requests=malloc(sizeof(MPI_Request)*2*ranks);
+    if(requests==NULL) {
+        fprintf(stderr, "ERROR Memory Allocation");
+        exit(1);
+    }
+    MPI_Datatype tile;
+    MPI_Type_vector(b, b, n, MPI_FLOAT, &tile);
+    MPI_Type_commit(&tile);
+    int count=0;
+    for (int d=1; d<ranks; d++) {
+        int source=(rank-d+ranks)%ranks;
+        MPI_Irecv(&T[0][source*b], 1, tile, source, 0, MPI_COMM_WORLD, &requests[count++]);
+    }
+    for (int d=1; d<ranks; d++) {
+        int dest=(rank+d)%ranks;
+        matTransposeTile(M, send, 0, dest*b, dest*b, 0, b, b, sublength);
+        MPI_Isend(send[dest*b], b*b, MPI_FLOAT, dest, 0, MPI_COMM_WORLD, &requests[count++]);
+    }
+    matTransposeTile(M, T, 0, rank*b, 0, rank*b, b, b, sublength);
+    MPI_Waitall(count, requests, MPI_STATUSES_IGNORE);
+    MPI_Type_free(&tile);
+    free(requests);
+    freeMatrixContiguous(send);
+    bool localSym=true;
+    for (int i=0; i<b && localSym; i++) {
+        for (int j=0; j<n && localSym; j++) {
+            if(ABS_DIFF(M[i][j],T[i][j])>ERROR) {
+                localSym=false;
+            }
+        }
+    }
+    bool symmetric=true;
+    MPI_Allreduce(&localSym, &symmetric, 1, MPI_C_BOOL, MPI_LAND, MPI_COMM_WORLD);
+    return symmetric;
+}
+/*
+ * Name: executionSampleMPI
+ * One sample of the MPI mode: every rank allocates and initializes only its row block (the global
+ * matrix never exists on one node), then all the ranks start together and the time of the sample is
+ * the one of the slowest rank
+ *   Input:
+ *      test (Test) - The test type used to initialize the matrix
+ *      n (int) - Size of the global Matrix (has to be a multiple of the number of ranks)
+ *      sublength (int) - Dimension of the submatrix for the local tiles
+ * Output: double - Time elapsed by the slowest rank
+ */
+double executionSampleMPI(Test test, int n, int sublength) {
+    int rank, ranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+    if(n%ranks!=0) {
+        if(rank==0) {
+            fprintf(stderr, "Error, the dimension %d has to be a multiple of the number of ranks %d\n", n, ranks);
+        }
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    const int b=n/ranks;
+    float** M=createFloatMatrixContiguous(b, n, MINIMUMSUBLENGTH);
+    float** T=createFloatMatrixContiguous(b, n, MINIMUMSUBLENGTH);
+    //Same seed on all the ranks, so the global matrix doesn't depend on the number of ranks
+    uint64_t seed=getTestSeed(test);
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    initializeMatrixRows(M, test, seed, n, rank*b, b);
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start=MPI_Wtime();
+    bool symmetric=executionProgramMPI(M, T, n, sublength);
+    double local=MPI_Wtime()-start;
+    double time=0.0;
+    MPI_Reduce(&local, &time, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    if(rank==0) {
+        printf("Time Elapsed (get time)=%.12f%s\n", time, symmetric ? " (symmetric)" : "");
+    }
+    freeMatrixContiguous(M);
+    freeMatrixContiguous(T);
+    return time;
+}
+#endif
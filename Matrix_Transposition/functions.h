@@ -7,6 +7,9 @@
 
 #ifndef functions_h
 #define functions_h
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE //pthread_setaffinity_np and CPU_SET
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -19,16 +22,35 @@
 #ifdef _OPENMP
 #include <omp.h>
 #endif
+#ifdef USE_MPI
+#include <mpi.h> //compile with mpicc -DUSE_MPI
+#endif
 #include <time.h>
 #include <string.h>
 #include <math.h> //-lm
+#include <pthread.h> //-pthread
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/resource.h> //getrusage
+#include <poll.h>
+#include <float.h>
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> //clflush, clflushopt with -march=native
+#endif
 #define KB 1024
 #define CACHESIZEL1D (32*KB)
 #define CACHESIZEL1I (32*KB)
 #define CACHESIZEL2 (1024*KB)
 #define CACHESIZEL3 (36*KB*KB)
-#define MINIMUMSUBLENGTH pow(2, 4)/2
-#define MAXIMUMSUBLENGTH sqrt(CACHESIZEL1D/(2*sizeof(float)))
+//Integer constants (pow(2, 4)/2 and sqrt(CACHESIZEL1D/(2*sizeof(float)))), usable in the specialized kernels
+#define MINIMUMSUBLENGTH 8
+#define MAXIMUMSUBLENGTH 64
+//Hierarchical tiling: L1 tiles (sublength, unrolled in registers by the specialized kernels) in L2 panels in LLC super-blocks
+#define PANELLENGTH 256     //sqrt(CACHESIZEL2/(2*sizeof(float)))=362 down to a power of 2, M and T panels in L2
+#define SUPERLENGTH 1024    //a row of T in a super-block is a 4KB page, the pages of a panel fit in the TLB
 #define FILENAMETGEN "timesGeneral.csv"
 #define FILENAMETSEQ "timesSequential.csv"
 #define FILENAMETIMPSTAND "timesImpStandard.csv"
@@ -37,6 +59,12 @@
 #define FILENAMETOMPGLBWS "timesOMPGlbWS.csv"
 #define FILENAMETOMPLOCBB "timesOMPLocBB.csv"
 #define FILENAMETOMPGLBBB "timesOMPGlbBB.csv"
+#define FILENAMETMPIBB "timesMPIBB.csv"
+#define FILENAMETPTHBB "timesPTHBB.csv"
+#define FILENAMETSPARSE "timesSparseCSR.csv"
+#define FILENAMETPIPE "timesPipeline.csv"
+#define FILENAMETHIER "timesHierarchical.csv"
+#define FILENAMETAUTO "timesAuto.csv"
 //#define FILENAMETOMPLOCTB "timesOMPLocTB.csv"
 //#define FILENAMETOMPGLBTB "timesOMPGlbTB.csv"
 #define FILENAMEGEN "resultsGeneral.csv"
@@ -47,6 +75,12 @@
 #define FILENAMEOMPGLBWS "resultsOMPGlbWS.csv"
 #define FILENAMEOMPLOCBB "resultsOMPLocBB.csv"
 #define FILENAMEOMPGLBBB "resultsOMPGlbBB.csv"
+#define FILENAMEMPIBB "resultsMPIBB.csv"
+#define FILENAMEPTHBB "resultsPTHBB.csv"
+#define FILENAMESPARSE "resultsSparseCSR.csv"
+#define FILENAMEPIPE "resultsPipeline.csv"
+#define FILENAMEHIER "resultsHierarchical.csv"
+#define FILENAMEAUTO "resultsAuto.csv"
 //#define FILENAMEOMPLOCTB "resultsOMPLocTB.csv"
 //#define FILENAMEOMPGLBTB "resultsOMPGlbTB.csv"
 #define MIN(X, Y) (((X) < (Y)) ? (X) : (Y))
@@ -56,45 +90,372 @@
 #define ABS_DIFF(X, Y) (((X) > (Y)) ? (X)-(Y) : (Y)-(X))
 
 #define MAX_THREADS 64
-#define MIN_SIZE pow(2, 4)
-#define MAX_SIZE pow(2, 12)
-typedef enum {START, SEQ, IMP_STAND, IMP_REC, OMP_LOC_WS, OMP_GLB_WS, OMP_LOC_BB, OMP_GLB_BB, END} Mode;
+#define MIN_SIZE 16
+#define MAX_SIZE 4096
+#define MODESDESCRIPTION "1. Sequential Code\n2. Implicit Parallelism (Blocking)\n3. Implicit Parallelism (Recursive)\n4. Explicit Parallelism (OMP - SymLocalVar + Work-Sharing)\n5. Explicit Paralellelism (OMP - SymLocalVar + Block-Based)\n6. Explicit Parallelism (OMP - SymGeneralVar + Work-Sharing)\n7. Explicit Paralellelism (OMP - SymGeneralVar + Block-Based)\n8. Distributed Parallelism (MPI - Row Blocks + All-to-All Block Exchange, run with mpirun)\n9. Explicit Parallelism (Pthreads Pool - Tile Stealing Sym + Block-Based)\n10. Explicit Parallelism (OMP - Sparse CSR Sym + CSR to CSC Counting Sort)\n11. Explicit Parallelism (Pipeline of a stream of matrices - Load | OMP SymGeneralVar + Block-Based | Consume)\n12. Explicit Parallelism (OMP - SymGeneralVar + Hierarchical Block-Based: registers, L1, L2, LLC)\n13. Automatic (mode, threads and block chosen from the size, the caches and TRANSPOSE_PROFILE, threads as maximum)\n"
+typedef enum {START, SEQ, IMP_STAND, IMP_REC, OMP_LOC_WS, OMP_GLB_WS, OMP_LOC_BB, OMP_GLB_BB, MPI_BB, PTH_BB, SPARSE_CSR, PIPE_BB, HIER_BB, AUTO, END} Mode;
 //OMP_LOC_TB, OMP_GLB_TB, END} Mode;
 typedef enum {RANDOM, STATIC, SYM, WORST} Test;
+//Counters of the matrices of allocateMatrixPerMode (bytes with the array of the rows) and peak RSS of the process
+typedef struct {
+    long allocations;
+    long frees;
+    long bytes;         //allocated now
+    long peak_bytes;
+    long peak_rss;      //bytes
+} MemoryStats;
+//Environment variable with the calibration profile of AUTO (a results file, as resultsGeneral.csv)
+#define PROFILEVARIABLE "TRANSPOSE_PROFILE"
+//What AUTO executes
+typedef struct {
+    Mode mode;
+    int threads;
+    int sublength;
+} AutoPlan;
+//Sparse matrices: one element every SPARSEDENSITY is not zero in the generated ones
+#define SPARSEDENSITY 100
+//Compressed Sparse Row, the same struct holds a Compressed Sparse Column matrix (ptr on columns, idx are rows)
+typedef struct {
+    int rows;
+    int cols;
+    long nnz;
+    long* ptr;      //rows+1 (cols+1 for CSC) offsets in idx and val
+    int* idx;       //column (row for CSC) of each element, ordered in each row
+    float* val;
+} CSRMatrix;
+//Environment variable that enables the row/column sums prefilter before the check of symmetry
+#define PREFILTERVARIABLE "TRANSPOSE_PREFILTER"
+//Packed symmetric matrix: only the lower triangle, row by row ([i][j] with j<=i is at i*(i+1)/2+j)
+#define PACKEDINDEX(I, J) ((long)(I)*((I)+1)/2+(J))
+//Environment variable with the state of the caches at the start of a measure (cold, flush or warm)
+#define CACHEVARIABLE "TRANSPOSE_CACHE"
+//Environment variable with the padding of the rows of the aligned matrices (auto or number of cache lines)
+#define PADVARIABLE "TRANSPOSE_PAD"
+typedef enum {CACHE_COLD, CACHE_FLUSH, CACHE_WARM} CacheState;
+//Environment variable with the allocation of the destination in the executable (lazy or eager)
+#define DESTINATIONVARIABLE "TRANSPOSE_DESTINATION"
+//Environment variable with the verification of the result after each measure (full or checksum)
+#define VERIFYVARIABLE "TRANSPOSE_VERIFY"
+typedef enum {VERIFY_OFF, VERIFY_FULL, VERIFY_CHECKSUM} VerifyMode;
+typedef struct {
+    int n;
+    float* data;    //n*(n+1)/2 floats
+} PackedSymMatrix;
+//Matrix with the symmetry tracked per pair of mirrored blocks (bi, bj) and (bj, bi), bj<=bi, stored
+//as the packed matrix in PACKEDINDEX(bi, bj)
+typedef struct {
+    float** M;
+    int n;
+    int sublength;
+    int blocks;
+    unsigned char* dirty;       //pair written after the last check
+    unsigned char* asymmetric;  //pair different at the last check
+    long* dirtyList;            //dirty pairs, to recheck only them
+    long dirtyCount;
+    long asymmetricCount;
+} TrackedMatrix;
+//Transposed view of M: T[i][j] is read from tiles of T materialized only when requested
+typedef struct {
+    float** M;
+    int n;
+    int sublength;      //side of a tile
+    int blocks;
+    int slots;          //tiles kept in the cache
+    int* slotOf;        //slot of each tile of T (blocks*blocks, -1 not materialized)
+    long* tileOf;       //tile held by each slot (-1 empty)
+    int victim;         //next slot to replace (round robin)
+    float** cache;      //slots*sublength rows of sublength floats
+    long materialized;  //tiles transposed since the creation
+} TransposedView;
+//Pipeline: matrices of the stream in one sample and buffers in the ring between the stages
+#define PIPELINESTREAM 16
+#define PIPELINESLOTS 3
+typedef struct {
+    float*** M;             //ring of the start matrices
+    float*** T;             //ring of the destination matrices
+    bool* symmetric;        //result of the check of each slot
+    double checksum;        //what the consumer computed
+    Test test;
+    int n;
+    int sublength;
+    int slots;
+    int stream;
+    long produced;          //matrices loaded, transposed and consumed up to now
+    long transposed;
+    long consumed;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} Pipeline;
+//Pthreads backend
+#define CACHELINE 64
+//Environment variable with the placement policy of the threads (compact, spread, cores or a CPU list)
+#define PLACESVARIABLE "TRANSPOSE_PLACES"
+typedef struct {
+    int cpu;
+    int socket;
+    int core;
+} CPUInfo;
+//Function executed on one tile of a job, thread is the index of the worker in the pool
+typedef void (*TileFunction)(long tile, int thread, void* arg);
+//Tiles still to do of a worker: the owner and the thieves take them with a fetch and add on next
+typedef struct {
+    _Alignas(CACHELINE) atomic_long next;
+    long end;
+} TileRange;
+typedef struct {
+    int num_threads;
+    pthread_t* threads;         //num_threads-1 workers, the caller is the worker 0
+    int* cpus;                  //CPU on which each worker is pinned (-1 not pinned)
+    TileRange* ranges;
+    TileFunction function;
+    void* arg;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    long generation;            //incremented at each job, the workers wait for a new one
+    int running;                //workers that haven't finished the current job
+    bool shutdown;
+} ThreadPool;
+//Tracer: with TRANSPOSE_TRACE=<file.json> each thread records in its own ring the phases and the tiles it executes,
+//written at the end in the Chrome trace format (chrome://tracing, ui.perfetto.dev). When the ring is full the oldest
+//events are overwritten, so the end of the run is kept
+#define TRACEVARIABLE "TRANSPOSE_TRACE"
+#define TRACECAPACITY (1<<16)       //events per thread
+#define TRACETHREADS (2*MAX_THREADS) //threads with a ring (OMP team, pools, pipeline stages), the others aren't traced
+typedef struct {
+    const char* name;       //string literal
+    long tile;              //index of the tile or row, -1 for the phases
+    uint64_t begin;         //ns of CLOCK_MONOTONIC
+    uint64_t end;
+} TraceEvent;
+typedef struct {
+    _Alignas(CACHELINE) TraceEvent* events;
+    long count;             //events recorded, the last TRACECAPACITY are in events[count%TRACECAPACITY]
+    int cpu;                //where the thread was at its first event
+} TraceBuffer;
+//Checked before taking the time, so without TRANSPOSE_TRACE the cost is a branch
+extern bool traceEnabled;
+#define TRACE_START(VAR) const uint64_t VAR=traceEnabled ? traceNow() : 0
+#define TRACE_STOP(NAME, TILE, VAR) if(traceEnabled) { traceRecord(NAME, TILE, VAR); }
+//Asynchronous jobs: check and transposition (as executionProgram) executed by a background pool
+typedef enum {ASYNC_QUEUED, ASYNC_RUNNING, ASYNC_DONE, ASYNC_CANCELLED} AsyncState;
+typedef struct AsyncJob {
+    float** M;
+    float** T;
+    int size;
+    int sublength;
+    int blocks;
+    long tiles;                 //tiles of the check (lower triangle) + tiles of the transposition
+    atomic_long tiles_done;
+    atomic_int state;           //AsyncState
+    atomic_bool cancel;         //looked at the start of each tile
+    atomic_bool symmetric;
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    struct AsyncJob* next;      //queue of the executor
+} AsyncJob;
+typedef struct {
+    ThreadPool* pool;           //created by the dispatcher, that is its worker 0
+    pthread_t dispatcher;
+    int num_threads;
+    int* cpus;
+    AsyncJob* head;             //jobs still to start, in order of submission
+    AsyncJob* tail;
+    AsyncJob* current;          //job in execution (NULL between the jobs)
+    pthread_mutex_t lock;
+    pthread_cond_t queued;
+    bool shutdown;
+} AsyncExecutor;
+//Daemon: socket path (TRANSPOSE_SOCKET to change it), requests read before executing them and
+//the biggest request (in elements) done by a single thread in batch with the other small ones
+#define SOCKETVARIABLE "TRANSPOSE_SOCKET"
+#define DAEMONSOCKET "/tmp/transpose.sock"
+#define DAEMONCLIENTS 64
+#define DAEMONBATCH 64
+#define DAEMONSMALL (128*128)
+typedef enum {REQ_TRANSPOSE=1, REQ_CHECK, REQ_CHECK_TRANSPOSE} RequestType;
+typedef struct {
+    uint64_t id;            //chosen by the client, copied in the reply
+    uint32_t type;          //RequestType
+    uint32_t rows;          //dimensions of M (T is cols x rows), square for the check
+    uint32_t cols;
+    uint32_t sublength;     //0 for the default
+    uint64_t offset_in;     //bytes from the start of the memfd to M (rows x cols floats, row-major)
+    uint64_t offset_out;    //bytes from the start of the memfd to T
+} DaemonRequest;
+typedef struct {
+    uint64_t id;
+    int32_t status;         //0 or the errno of the failure
+    int32_t symmetric;      //result of the check (REQ_CHECK, REQ_CHECK_TRANSPOSE)
+} DaemonReply;
+typedef struct {
+    DaemonRequest request;
+    int client;             //socket to reply to
+    int fd;                 //memfd of the client
+    void* map;              //mapping of the memfd
+    size_t length;
+    float** M;              //rows of M and T in the mapping (from the pool of the arrays of pointers)
+    float** T;
+    DaemonReply reply;
+} DaemonJob;
 //Number generation
 float random_float2 (int min, int max);
+uint64_t splitmix64(uint64_t x);
+float counter_float2(uint64_t seed, long i, long j, int min, int max);
+uint64_t getTestSeed(Test test);
 //Input Management
 void inputParameters(int argc);
 int valueInputed(int argc, const char* argv, int value);
 int threadInit(const char* argv, int argc, int mode);
+int threadSetup(int num_threads, int mode);
+double getWallTime(void);
+int getAvailableCPUs(void);
+AutoPlan chooseAutoPlan(int n, size_t element, int test, int max_threads);
 //Generation and deleting
 float** createFloatSquareMatrix(int n);
 float** createFloatSquareMatrixAligned(int n, int sublength);
+float** createFloatMatrixContiguous(int rows, int cols, int sublength);
+float** createFloatMatrixPadded(int rows, int cols, int ld, int sublength);
+int getLeadingDimension(int cols);
 float** allocateMatrixPerMode(Mode mode, int n);
+void freeMatrixPerMode(Mode mode, float** M, int n);
+MemoryStats getMemoryStats(void);
+void printMemoryStats(void);
 void initializeMatrix(float** M, Test test, int n);
+void initializeMatrixRows(float** M, Test test, uint64_t seed, int n, int row_start, int rows);
 void freeMemory(float** M, int size);
+void freeMatrixContiguous(float** M);
 //Execution
-bool executionProgram(float** M, float** T, Mode mode, int n, int sublength);
+bool executionProgram(float** M, float*** T, Mode mode, int n, int sublength);
 //Check Symmetry Algorithms
 bool checkSym (float** M, int size);
 bool checkSymImpStandard (float** M, int size, int sublength);
+bool checkSymTile (float** M, int size, int i, int j, int sublength);
 bool checkSymImpRecursive (float** M, int start_r, int end_r, int start_c, int end_c, int SUBLENGTH);
 bool checkSymOMPLocal (float** M, int size);
 bool checkSymOMPGlobal (float** M, int size);
+bool checkSymPrefilter (float** M, int size);
+//Compile-time specialized kernels: each tile size of TILE_KERNELS has its own fully unrolled kernel
+//(T[t_r+k][t_c+l]=M[m_r+l][m_c+k] on a full tile) and each pair (matrix size, tile size) of FIXED_KERNELS
+//has a sequential transposition without bounds. Sizes not listed go to the generic kernels
+typedef void (*TileKernel)(float** M, float** T, int m_r, int m_c, int t_r, int t_c);
+typedef void (*MatrixKernel)(float** M, float** T);
+#define TILE_KERNELS(X) X(8) X(16) X(32) X(64)
+#define FIXED_KERNELS(X) \
+    X(16, 8) \
+    X(32, 8) X(32, 16) \
+    X(64, 8) X(64, 16) X(64, 32) \
+    X(128, 8) X(128, 16) X(128, 32) X(128, 64) \
+    X(256, 8) X(256, 16) X(256, 32) X(256, 64) \
+    X(512, 8) X(512, 16) X(512, 32) X(512, 64) \
+    X(1024, 8) X(1024, 16) X(1024, 32) X(1024, 64)
+TileKernel getTileKernel(int sublength);
+MatrixKernel getFixedKernel(int n, int sublength);
 //Transposition Algorithms
 void matTranspose (float** M, float** T, int size);
 void matTransposeImpStandard (float** M, float** T, int size, int sublength);
 void matTransposeImpRecursive (float** M, float** T, int start_r, int end_r, int start_c, int end_c, int SUBLENGTH);
 void matTransposeOMPWorkSharing (float** M, float** T,int size);
 void matTransposeOMPBlockingBased (float** M, float** T, int size, int sublength);
+void matTransposeHierarchical (float** M, float** T, int size, int sublength);
+void matTransposeTile (float** M, float** T, int m_r, int m_c, int t_r, int t_c, int rows, int cols, int sublength);
+bool matTransposeInPlace (float* A, int rows, int cols, int sublength);
+//Fused copy B=alpha*op(A)+beta*B (omatcopy), B can be stored in float, bfloat16 or half
+typedef enum {OP_NONE, OP_TRANS} MatrixOp;
+typedef enum {OUT_F32, OUT_BF16, OUT_F16} OutputType;
+uint16_t floatToBF16(float f);
+float bf16ToFloat(uint16_t h);
+uint16_t floatToHalf(float f);
+float halfToFloat(uint16_t h);
+void matOmatcopy (MatrixOp op, int rows, int cols, float alpha, float** A, float beta, void** B, OutputType type, int sublength);
+//Permutation of the axes of a tensor (NCHW <-> NHWC, ...) as a batch of 2D transpositions
+#define TENSORMAXDIMS 8
+void tensorPermute (const float* src, float* dst, int ndim, const long* shape, const int* perm, int sublength);
+//Distributed Execution (MPI)
+int getRank(void);
+//Sparse Matrices
+CSRMatrix* createCSR(int rows, int cols, long nnz);
+CSRMatrix* generateSparseCSR(Test test, int n);
+void freeCSR(CSRMatrix* A);
+bool checkSymCSR(const CSRMatrix* A, bool* structural);
+void csrToCSC(const CSRMatrix* A, CSRMatrix* C);
+bool executionProgramSparse(const CSRMatrix* A, CSRMatrix* C);
+double executionSampleSparse(Test test, int n);
+//Packed Symmetric Matrices
+PackedSymMatrix* packSymmetric(float** M, int n);
+float packedGet(const PackedSymMatrix* P, int i, int j);
+void packedSet(PackedSymMatrix* P, int i, int j, float value);
+PackedSymMatrix* matTransposePacked(PackedSymMatrix* P);
+void unpackSymmetric(const PackedSymMatrix* P, float** M);
+void freePacked(PackedSymMatrix* P);
+//Incremental Symmetry
+TrackedMatrix* trackMatrix(float** M, int n, int sublength);
+void trackedMarkDirty(TrackedMatrix* TM, int i, int j);
+void trackedSet(TrackedMatrix* TM, int i, int j, float value);
+bool checkSymTracked(TrackedMatrix* TM);
+void untrackMatrix(TrackedMatrix* TM);
+//Lazy Transposed Views
+TransposedView* createTransposedView(float** M, int n, int sublength, int slots);
+const float* viewTileRow(TransposedView* V, int i, int bj);
+float viewGet(TransposedView* V, int i, int j);
+void viewMaterializeAll(TransposedView* V, float** T);
+void freeTransposedView(TransposedView* V);
+//Pipeline of Matrices
+double executionPipeline(Test test, int n, int sublength, int stream, int slots);
+double executionSamplePipeline(Test test, int n, int sublength);
+//Thread Placement
+int* getPlacement(const char* policy, int num_threads);
+void pinCurrentThread(int cpu);
+void printThreadPlacement(int thread, int num_threads, pthread_t handle);
+//Pthreads Backend
+ThreadPool* threadPoolCreate(int num_threads, const int* cpus);
+void threadPoolRun(ThreadPool* pool, long tiles, TileFunction function, void* arg);
+void threadPoolDestroy(ThreadPool* pool);
+ThreadPool* getDefaultThreadPool(void);
+bool checkSymPthreads(ThreadPool* pool, float** M, int size, int sublength);
+void matTransposePthreads(ThreadPool* pool, float** M, float** T, int size, int sublength);
+//Tracer
+void traceInit(void);
+uint64_t traceNow(void);
+void traceRecord(const char* name, long tile, uint64_t begin);
+void traceWrite(void);
+//Asynchronous API: the handle is returned at once, the job runs on the pool of the executor
+AsyncExecutor* asyncCreate(int num_threads, const int* cpus);
+AsyncJob* asyncSubmit(AsyncExecutor* executor, float** M, float** T, int size, int sublength);
+AsyncState asyncPoll(AsyncJob* job);
+AsyncState asyncWait(AsyncJob* job);
+double asyncProgress(AsyncJob* job);
+void asyncCancel(AsyncJob* job);
+bool asyncSymmetric(AsyncJob* job);
+void asyncRelease(AsyncJob* job);
+void asyncDestroy(AsyncExecutor* executor);
+//Daemon (daemon.c): requests on a UNIX socket, the matrices stay in a memfd of the client passed with SCM_RIGHTS
+int daemonListen(const char* path);
+int daemonConnect(const char* path);
+int daemonSend(int sock, const DaemonRequest* request, int fd);
+int daemonReceive(int sock, DaemonRequest* request, int* fd);
+void daemonExecute(ThreadPool* pool, DaemonJob* jobs, int count);
+#ifdef USE_MPI
+bool executionProgramMPI(float** M, float** T, int n, int sublength);
+double executionSampleMPI(Test test, int n, int sublength);
+#endif
 //void matTransposeOMPTaskBased (float** M, float** T, int start_r, int end_r, int start_c, int end_c, int SUBLENGTH);
 //Control Results
 void printMatrix(float** M, int size);
 void control(float** M, float** T, int N);
+long verifyTranspose(float** M, float** T, int rows, int cols, float tolerance, int sublength);
+uint64_t checksumMatrix(float** M, int rows, int cols, bool transposed);
+VerifyMode getVerifyMode(void);
+long verifyExecution(float** M, float** T, int n, bool symmetric, int sublength);
 void bubbleSort(double* a, int size);
 //Cache Management
 void clearCache(long long int dimCache);
 void clearAllCache(void);
+void flushMatrix(float** M, int rows, int cols);
+void warmMatrix(float** M, int rows, int cols);
+CacheState getCacheState(void);
+void prepareCache(float** M, float** T, int n);
+bool eagerDestination(void);
 //Files csv Management
 double getSequential(const int dim, const int test);
 void executeCommand(char command[]);
@@ -9,6 +9,8 @@
 //Too avoid outlayer
 //qsub -I -q short_cpuQ -l select=1:ncpus=64:ompthreads=64:mem=1Gb
 //NO -O3
+//MPI mode (8): mpicc -DUSE_MPI -O2 functions.c main.c -o transpose -fopenmp -lm
+//mpirun -np 4 ./transpose MPIBB 8 <size> <test_mode> <samples>
 #include <stdio.h>
 #include "functions.h"
 
@@ -19,25 +21,37 @@ int main(int argc, const char * argv[]) {
     float** M=NULL;
     float** T=NULL;
     //struct timeval start_tv, end_tv;
-    //#ifdef _OPENMP
-    #ifdef _OPENMP
-        double tw_start=0.0, tw_end=0.0;
+    double tw_start=0.0, tw_end=0.0;
+    #ifdef USE_MPI
+        MPI_Init(&argc, (char***)&argv);
     #endif
-    //#endif
+    const int RANK=getRank();
     //Input parameters
     inputParameters(argc);
+    traceInit();
     const char* CODE=argv[1];
     const Mode MODE=valueInputed(argc, argv[2], 2);
     const int N=valueInputed(argc, argv[3], 3);
     const int TESTING=valueInputed(argc, argv[4], 4);
     const int SAMPLES=valueInputed(argc, argv[5], 5);
-    const int NUM_THREADS=threadInit(argv[6], argc, MODE);
+    //AUTO chooses the mode executed, the threads (the inputed ones are the maximum) and the block, but the results are saved as AUTO
+    AutoPlan plan={.mode=MODE, .threads=0, .sublength=0};
+    if(MODE==AUTO) {
+        plan=chooseAutoPlan(N, sizeof(float), TESTING, (argc==7) ? valueInputed(argc, argv[6], 6) : getAvailableCPUs());
+        printf("AUTO: mode %d, %d threads, block %d\n", plan.mode, plan.threads, plan.sublength);
+    }
+    const Mode EXEC_MODE=plan.mode;
+    const int NUM_THREADS=(MODE==AUTO) ? threadSetup(plan.threads, EXEC_MODE) : threadInit(argv[6], argc, MODE);
     if(N/2<MINIMUMSUBLENGTH) {
         fprintf(stderr, "Error, input dimension under the limit\n");
         exit(1);
     }
-    int SUBLENGTH=MAX(MIN(N/2, MAXIMUMSUBLENGTH/NUM_THREADS), MINIMUMSUBLENGTH);
-    printf("%d\n\n", SUBLENGTH);
+    //Ranks don't share the L1 cache, so in MPI the block is chosen as for one thread
+    const int CACHE_SHARERS=(MODE==MPI_BB) ? 1 : NUM_THREADS;
+    int SUBLENGTH=(MODE==AUTO) ? plan.sublength : MAX(MIN(N/2, MAXIMUMSUBLENGTH/CACHE_SHARERS), MINIMUMSUBLENGTH);
+    if(RANK==0) {
+        printf("%d\n\n", SUBLENGTH);
+    }
     double* results=malloc(sizeof(double)*SAMPLES);
     if (results==NULL) {
         fprintf(stderr, "ERROR Memory Allocation");
@@ -45,40 +59,71 @@ int main(int argc, const char * argv[]) {
     }
     //Optimized Length Function
     while (count<SAMPLES) {
+        if(MODE==MPI_BB || MODE==SPARSE_CSR || MODE==PIPE_BB) {
+            clearAllCache();
+            TRACE_START(sample);
+            if(MODE==SPARSE_CSR) {
+                time=executionSampleSparse(TESTING, N);
+            }
+            else if(MODE==PIPE_BB) {
+                time=executionSamplePipeline(TESTING, N, SUBLENGTH);
+            }
+            #ifdef USE_MPI
+            else {
+                //Each rank allocates and initializes its own row block
+                time=executionSampleMPI(TESTING, N, SUBLENGTH);
+            }
+            #endif
+            TRACE_STOP("sample", count, sample);
+            if(RANK==0) {
+                openFilesResultsPerMode(CODE, MODE, N, TESTING, SAMPLES, NUM_THREADS, time);
+            }
+            results[count]=time;
+            count++;
+            continue;
+        }
         //Allocation in memory
-        clearAllCache();
-        M=allocateMatrixPerMode(MODE, N);
-        T=allocateMatrixPerMode(MODE, N);
+        //T is allocated by executionProgram only if M isn't symmetric, with TRANSPOSE_DESTINATION=eager it's allocated
+        //here, so malloc isn't measured and T gets the same cache state of M (as in Final Results)
+        M=allocateMatrixPerMode(EXEC_MODE, N);
+        T=eagerDestination() ? allocateMatrixPerMode(EXEC_MODE, N) : NULL;
         initializeMatrix(M, TESTING, N);
+        //After the initialization, otherwise M is again in cache
+        prepareCache(M, T, N);
         //Starting
         //if(MODE>=OMP_LOC_WS && MODE<=OMP_GLB_TB) {
-        #ifdef _OPENMP
-                tw_start=omp_get_wtime();
-        #endif
+        tw_start=getWallTime();
         //}
         //else {
         //    gettimeofday(&start_tv, NULL);
         //}
         //Modalities
-        bool symmetric=executionProgram(M, T, MODE, N, SUBLENGTH);
+        TRACE_START(sample);
+        bool symmetric=executionProgram(M, &T, EXEC_MODE, N, SUBLENGTH);
+        TRACE_STOP("executionProgram", count, sample);
         //control(M, T, N);
         //Ending
         //if(MODE>=OMP_LOC_WS && MODE<=OMP_GLB_TB) {
-        #ifdef _OPENMP
-            tw_end=omp_get_wtime();
-            time=(tw_end-tw_start);
-            printf("Time Elapsed (get time)=%.12f\n", time);
-        #endif
+        tw_end=getWallTime();
+        time=(tw_end-tw_start);
+        printf("Time Elapsed (get time)=%.12f\n", time);
         //}
         /*else {
             gettimeofday(&end_tv, NULL);
             time=end_tv.tv_sec-start_tv.tv_sec+(end_tv.tv_usec-start_tv.tv_usec)*1e-6;
             printf("Time Elapsed (get time)=%.6f\n", time);
         }*/
+        //Verification of the result (TRANSPOSE_VERIFY), after the measure
+        const long errors=verifyExecution(M, T, N, symmetric, SUBLENGTH);
+        if(errors>0) {
+            fprintf(stderr, "Verification failed at sample %d: %ld elements wrong\n", count, errors);
+            exit(1);
+        }
         //Free Memory
-        freeMemory(M, N);
-        if(!symmetric) {
-            freeMemory(T, N);
+        freeMatrixPerMode(EXEC_MODE, M, N);
+        if(T!=NULL) {
+            freeMatrixPerMode(EXEC_MODE, T, N);
+            T=NULL;
         }
         //Incrementing
         openFilesResultsPerMode(CODE, MODE, N, TESTING, SAMPLES, NUM_THREADS, time);
@@ -94,10 +139,20 @@ int main(int argc, const char * argv[]) {
     bubbleSort(results, SAMPLES);
     for (int i=start; i<end; i++) {
         total_time+=results[i];
-        printf("%.12lf\n", results[i]);
+        if(RANK==0) {
+            printf("%.12lf\n", results[i]);
+        }
+    }
+    if(RANK==0) {
+        printf("\n\nFINAL RESULTS WITH:\nMODE %d\nDimension: %d\nTesting: %d\nSamples: %d\nThreads: %d\nAverage Time: %.12lf secs\n\n", MODE, N, TESTING, SAMPLES, NUM_THREADS, total_time/TAKE_SAMPLES);
+        openFilesAvgPerMode(CODE, MODE, N, TESTING, SAMPLES, NUM_THREADS, total_time/TAKE_SAMPLES);
+        printMemoryStats();
     }
-    printf("\n\nFINAL RESULTS WITH:\nMODE %d\nDimension: %d\nTesting: %d\nSamples: %d\nThreads: %d\nAverage Time: %.12lf secs\n\n", MODE, N, TESTING, SAMPLES, NUM_THREADS, total_time/TAKE_SAMPLES);
-    openFilesAvgPerMode(CODE, MODE, N, TESTING, SAMPLES, NUM_THREADS, total_time/TAKE_SAMPLES);
     free(results);
+    traceWrite();
+    threadPoolDestroy(getDefaultThreadPool());
+    #ifdef USE_MPI
+        MPI_Finalize();
+    #endif
     return 0;
 }
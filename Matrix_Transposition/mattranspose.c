@@ -0,0 +1,245 @@
+//
+//  mattranspose.c
+//  Matrix Transposition
+//
+//Python extension: the kernels on any C-contiguous float32 array of the buffer protocol (NumPy,
+//memoryview, array), without copies and releasing the GIL while they run
+//python3 setup.py build_ext --inplace
+//  import numpy as np, mattranspose
+//  T=np.empty((cols, rows), dtype=np.float32); mattranspose.transpose(M, T)
+#define PY_SSIZE_T_CLEAN
+#include <Python.h> //first, as required by Python
+#include "functions.h"
+
+/*
+ * Name: getMatrix
+ * Gets the buffer of a 2D C-contiguous float32 array
+ * Input:
+ *      object (PyObject*) - The array
+ *      view (Py_buffer*) - Where to put the buffer (to release with PyBuffer_Release)
+ *      writable (int) - 1 if the kernel writes in it
+ * Output: int - 0, -1 with the Python exception set
+ */
+static int getMatrix(PyObject* object, Py_buffer* view, int writable) {
+    if(PyObject_GetBuffer(object, view, PyBUF_C_CONTIGUOUS|PyBUF_FORMAT|(writable ? PyBUF_WRITABLE : 0))<0) {
+        return -1;
+    }
+    if(view->ndim!=2 || view->itemsize!=sizeof(float) || view->format==NULL || strcmp(view->format, "f")!=0) {
+        PyErr_SetString(PyExc_TypeError, "a 2D C-contiguous float32 array is required");
+        PyBuffer_Release(view);
+        return -1;
+    }
+    if(view->shape[0]>INT_MAX || view->shape[1]>INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "the array is too big");
+        PyBuffer_Release(view);
+        return -1;
+    }
+    return 0;
+}
+/*
+ * Name: getRows
+ * Array of the pointers to the rows of a buffer, as the kernels want it
+ * Input:
+ *      data (void*) - Start of the buffer
+ *      rows (Py_ssize_t) - Number of rows
+ *      cols (Py_ssize_t) - Number of columns (distance between two rows)
+ * Output: float** - The array (to free), NULL with the Python exception set
+ */
+static float** getRows(void* data, Py_ssize_t rows, Py_ssize_t cols) {
+    float** temp=PyMem_Malloc(sizeof(float*)*(rows>0 ? rows : 1));
+    if(temp==NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (Py_ssize_t i=0; i<rows; i++) {
+        temp[i]=(float*)data+i*cols;
+    }
+    return temp;
+}
+/*
+ * Name: getSublength
+ * Checks the submatrix asked by Python (0 means the default MAXIMUMSUBLENGTH)
+ */
+static int getSublength(int sublength) {
+    if(sublength==0) {
+        return MAXIMUMSUBLENGTH;
+    }
+    if(sublength<1 || sublength>MAXIMUMSUBLENGTH) {
+        PyErr_Format(PyExc_ValueError, "sublength has to be between 1 and %d", MAXIMUMSUBLENGTH);
+        return -1;
+    }
+    return sublength;
+}
+
+static PyObject* pyTranspose(PyObject* self, PyObject* args, PyObject* kwargs) {
+    (void)self;
+    static char* keywords[]={"src", "dst", "sublength", NULL};
+    PyObject* src=NULL;
+    PyObject* dst=Py_None;
+    int sublength=0;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "O|Oi", keywords, &src, &dst, &sublength) || (sublength=getSublength(sublength))<0) {
+        return NULL;
+    }
+    Py_buffer in, out;
+    if(getMatrix(src, &in, 0)<0) {
+        return NULL;
+    }
+    const Py_ssize_t rows=in.shape[0], cols=in.shape[1];
+    //Without dst the result is a new bytearray seen as a (cols, rows) memoryview (np.asarray works on it)
+    PyObject* result=NULL;
+    if(dst==Py_None) {
+        PyObject* bytes=PyByteArray_FromStringAndSize(NULL, rows*cols*(Py_ssize_t)sizeof(float));
+        PyObject* flat=(bytes!=NULL) ? PyMemoryView_FromObject(bytes) : NULL;
+        result=(flat!=NULL) ? PyObject_CallMethod(flat, "cast", "s(nn)", "f", cols, rows) : NULL;
+        Py_XDECREF(flat);
+        Py_XDECREF(bytes);
+        if(result==NULL) {
+            PyBuffer_Release(&in);
+            return NULL;
+        }
+        dst=result;
+    }
+    if(getMatrix(dst, &out, 1)<0) {
+        Py_XDECREF(result);
+        PyBuffer_Release(&in);
+        return NULL;
+    }
+    if(out.shape[0]!=cols || out.shape[1]!=rows) {
+        PyErr_Format(PyExc_ValueError, "dst has to be (%zd, %zd)", cols, rows);
+        PyBuffer_Release(&out);
+        PyBuffer_Release(&in);
+        Py_XDECREF(result);
+        return NULL;
+    }
+    //The kernel reads M while it writes T: the same square array is transposed in place (no extra memory
+    //in the square case), any other overlap would read values already overwritten
+    const char* in_start=in.buf;
+    const char* out_start=out.buf;
+    if(in_start==out_start && rows==cols) {
+        bool done;
+        Py_BEGIN_ALLOW_THREADS
+        done=matTransposeInPlace((float*)out.buf, (int)rows, (int)cols, sublength);
+        Py_END_ALLOW_THREADS
+        PyBuffer_Release(&out);
+        PyBuffer_Release(&in);
+        if(!done) {
+            Py_XDECREF(result);
+            return PyErr_NoMemory();
+        }
+        Py_INCREF(dst);
+        return dst;
+    }
+    if(in_start<out_start+out.len && out_start<in_start+in.len) {
+        PyErr_SetString(PyExc_ValueError, "src and dst overlap, use transpose_inplace");
+        PyBuffer_Release(&out);
+        PyBuffer_Release(&in);
+        Py_XDECREF(result);
+        return NULL;
+    }
+    float** M=getRows(in.buf, rows, cols);
+    float** T=getRows(out.buf, cols, rows);
+    if(M!=NULL && T!=NULL) {
+        Py_BEGIN_ALLOW_THREADS
+        matOmatcopy(OP_TRANS, (int)rows, (int)cols, 1.0f, M, 0.0f, (void**)T, OUT_F32, sublength);
+        Py_END_ALLOW_THREADS
+    }
+    PyMem_Free(M);
+    PyMem_Free(T);
+    PyBuffer_Release(&out);
+    PyBuffer_Release(&in);
+    if(PyErr_Occurred()) {
+        Py_XDECREF(result);
+        return NULL;
+    }
+    if(result!=NULL) {
+        return result;
+    }
+    Py_INCREF(dst);
+    return dst;
+}
+
+static PyObject* pyTransposeInPlace(PyObject* self, PyObject* args, PyObject* kwargs) {
+    (void)self;
+    static char* keywords[]={"buffer", "rows", "cols", "sublength", NULL};
+    PyObject* object=NULL;
+    Py_ssize_t rows=-1, cols=-1;
+    int sublength=0;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "O|nni", keywords, &object, &rows, &cols, &sublength) || (sublength=getSublength(sublength))<0) {
+        return NULL;
+    }
+    Py_buffer view;
+    if(PyObject_GetBuffer(object, &view, PyBUF_C_CONTIGUOUS|PyBUF_FORMAT|PyBUF_WRITABLE)<0) {
+        return NULL;
+    }
+    //A 2D array gives its shape, a flat buffer needs rows and cols
+    if(rows<0 && view.ndim==2) {
+        rows=view.shape[0];
+        cols=view.shape[1];
+    }
+    if(view.itemsize!=sizeof(float) || view.format==NULL || strcmp(view.format, "f")!=0 || rows<0 || cols<0 ||
+       rows*cols*(Py_ssize_t)sizeof(float)!=view.len || rows>INT_MAX || cols>INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "a C-contiguous float32 buffer of rows*cols elements is required");
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    bool done;
+    Py_BEGIN_ALLOW_THREADS
+    done=matTransposeInPlace((float*)view.buf, (int)rows, (int)cols, sublength);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+    if(!done) {
+        return PyErr_NoMemory();
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* pyIsSymmetric(PyObject* self, PyObject* args) {
+    (void)self;
+    PyObject* src=NULL;
+    if(!PyArg_ParseTuple(args, "O", &src)) {
+        return NULL;
+    }
+    Py_buffer in;
+    if(getMatrix(src, &in, 0)<0) {
+        return NULL;
+    }
+    if(in.shape[0]!=in.shape[1]) {
+        PyBuffer_Release(&in);
+        Py_RETURN_FALSE;
+    }
+    float** M=getRows(in.buf, in.shape[0], in.shape[1]);
+    bool symmetric=false;
+    if(M!=NULL) {
+        Py_BEGIN_ALLOW_THREADS
+        symmetric=checkSymOMPGlobal(M, (int)in.shape[0]);
+        Py_END_ALLOW_THREADS
+    }
+    PyMem_Free(M);
+    PyBuffer_Release(&in);
+    if(PyErr_Occurred()) {
+        return NULL;
+    }
+    return PyBool_FromLong(symmetric);
+}
+
+static PyMethodDef methods[]={
+    {"transpose", (PyCFunction)(void(*)(void))pyTranspose, METH_VARARGS|METH_KEYWORDS,
+     "transpose(src, dst=None, sublength=0)\n\nTransposes the 2D float32 array src in dst (shape (cols, rows)) with the\n"
+     "parallel block kernel. Without dst it returns a new memoryview. The GIL is released while it runs.\n"
+     "If dst is src (square) it is transposed in place, any other overlap raises ValueError."},
+    {"transpose_inplace", (PyCFunction)(void(*)(void))pyTransposeInPlace, METH_VARARGS|METH_KEYWORDS,
+     "transpose_inplace(buffer, rows=-1, cols=-1, sublength=0)\n\nTransposes in place a C-contiguous float32 buffer of rows x cols\n"
+     "elements (taken from the shape of a 2D array), with the cycle-following kernel. Afterwards it is cols x rows."},
+    {"is_symmetric", pyIsSymmetric, METH_VARARGS,
+     "is_symmetric(src)\n\nTrue if the 2D float32 array src is symmetric (with the tolerance of the kernels)."},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef module={
+    PyModuleDef_HEAD_INIT, "mattranspose", "Matrix transposition kernels on buffer-protocol arrays.", -1, methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_mattranspose(void) {
+    return PyModule_Create(&module);
+}
@@ -0,0 +1,569 @@
+//
+//  selftest.c
+//  Matrix Transposition
+//
+//Self-test of the parts of the library that the executable doesn't measure: each check compares the
+//result with a naive reference (checkSym, matTranspose, loops on the indexes) and prints OK or FAILED.
+//The exit status is the number of checks failed
+//gcc -O2 functions.c selftest.c -o transpose_selftest -fopenmp -lm -pthread
+//./transpose_selftest [size]    (size not a multiple of the block, so the partial tiles are tested too)
+#include "functions.h"
+
+static int failures=0;
+
+/*
+ * Name: report
+ * Print the result of a check and count it if failed
+ * Input:
+ *      name (const char*) - Name of the check
+ *      ok (bool) - Result
+ * Output: none
+ */
+static void report(const char* name, bool ok) {
+    printf("%-56s %s\n", name, ok ? "OK" : "FAILED");
+    if(!ok) {
+        failures++;
+    }
+}
+/*
+ * Name: fillSymmetric
+ * Random symmetric matrix: the lower triangle from counter_float2, mirrored on the upper one
+ * Input:
+ *      M (float**) - The matrix
+ *      n (int) - Size of Matrix
+ * Output: none
+ */
+static void fillSymmetric(float** M, int n) {
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<=i; j++) {
+            M[i][j]=M[j][i]=counter_float2(getTestSeed(STATIC), i, j, 0, 9999);
+        }
+    }
+}
+/*
+ * Name: testTracked
+ * Tracked symmetry: mutations of single elements (with trackedSet or writing M and calling
+ * trackedMarkDirty) alternated with checkSymTracked, whose result has to be the one of the full checkSym.
+ * Only the pairs of blocks written after the last check have to be dirty
+ * Input: n (int) - Size of Matrix
+ * Output: none
+ */
+static void testTracked(int n) {
+    const int sublength=16;
+    float** M=createFloatSquareMatrix(n);
+    fillSymmetric(M, n);
+    TrackedMatrix* TM=trackMatrix(M, n, sublength);
+    report("tracked: first check (all pairs dirty)", checkSymTracked(TM)==checkSym(M, n) && checkSym(M, n));
+    //One element of the last (partial) block row changed and then restored from the mirror
+    trackedSet(TM, n-1, 0, M[n-1][0]+1.0f);
+    bool ok=(TM->dirtyCount==1);
+    ok=ok && checkSymTracked(TM)==checkSym(M, n) && !checkSym(M, n);
+    M[0][n-1]=M[n-1][0];
+    trackedMarkDirty(TM, 0, n-1);
+    ok=ok && checkSymTracked(TM)==checkSym(M, n) && checkSym(M, n);
+    report("tracked: one tile changed, rechecked and restored", ok);
+    //Random writes: sometimes a single element (asymmetric), sometimes the element and its mirror
+    ok=true;
+    uint64_t state=12345;
+    for (int step=0; step<500 && ok; step++) {
+        state=splitmix64(state);
+        const int i=(int)(state%n);
+        const int j=(int)((state>>20)%n);
+        const float value=(float)((state>>40)%100);
+        trackedSet(TM, i, j, value);
+        if((state>>60)%2==0) {
+            trackedSet(TM, j, i, value);
+        }
+        ok=(checkSymTracked(TM)==checkSym(M, n));
+    }
+    report("tracked: 500 random writes agree with checkSym", ok);
+    //Everything symmetric again, pair by pair
+    fillSymmetric(M, n);
+    for (int i=0; i<n; i+=sublength) {
+        for (int j=0; j<n; j+=sublength) {
+            trackedMarkDirty(TM, i, j);
+        }
+    }
+    report("tracked: symmetric again after marking all the pairs", checkSymTracked(TM) && TM->asymmetricCount==0);
+    untrackMatrix(TM);
+    freeMemory(M, n);
+}
+/*
+ * Name: sameMatrix
+ * If two n x n matrices have exactly the same elements
+ */
+static bool sameMatrix(float** A, float** B, int n) {
+    for (int i=0; i<n; i++) {
+        if(memcmp(A[i], B[i], sizeof(float)*n)!=0) {
+            return false;
+        }
+    }
+    return true;
+}
+/*
+ * Name: testPacked
+ * Packed symmetric matrices of odd and even sizes (1, 2, 3, 17, n and n+1): packSymmetric has to keep
+ * packedGet(i, j)==packedGet(j, i)==M[i][j], matTransposePacked gives back the same matrix, packedSet
+ * writes also the mirror and unpackSymmetric rebuilds M over a destination with other values
+ * Input: n (int) - Largest size but one
+ * Output: none
+ */
+static void testPacked(int n) {
+    const int sizes[]={1, 2, 3, 17, n, n+1};
+    for (size_t s=0; s<sizeof(sizes)/sizeof(sizes[0]); s++) {
+        const int size=sizes[s];
+        float** M=createFloatSquareMatrix(size);
+        float** R=createFloatSquareMatrix(size);
+        fillSymmetric(M, size);
+        PackedSymMatrix* P=packSymmetric(M, size);
+        bool ok=(matTransposePacked(P)==P && P->n==size);
+        for (int i=0; i<size; i++) {
+            for (int j=0; j<size; j++) {
+                ok=ok && packedGet(P, i, j)==M[i][j] && packedGet(P, j, i)==M[i][j];
+            }
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "packed: pack and packedGet, size %d", size);
+        report(name, ok);
+        //An element of the upper triangle written in both, then the round trip
+        if(size>1) {
+            packedSet(P, 0, size-1, -1.0f);
+            M[0][size-1]=M[size-1][0]=-1.0f;
+        }
+        ok=(packedGet(P, size-1, 0)==M[size-1][0]);
+        for (int i=0; i<size; i++) {
+            for (int j=0; j<size; j++) {
+                R[i][j]=NAN;
+            }
+        }
+        unpackSymmetric(P, R);
+        snprintf(name, sizeof(name), "packed: packedSet and unpack, size %d", size);
+        report(name, ok && sameMatrix(R, M, size));
+        freePacked(P);
+        freeMemory(R, size);
+        freeMemory(M, size);
+    }
+}
+/*
+ * Name: testView
+ * Transposed view compared with matTransposeOMPBlockingBased: element by element by rows and by columns
+ * of T with a cache of 3 tiles (so the tiles are evicted and transposed again), by bands with viewTileRow
+ * and all at once with viewMaterializeAll. n not multiple of the tile gives the partial edge tiles
+ * Input: n (int) - Size of Matrix
+ * Output: none
+ */
+static void testView(int n) {
+    const int sublength=16;
+    const int blocks=(n+sublength-1)/sublength;
+    float** M=createFloatSquareMatrix(n);
+    float** T=createFloatSquareMatrix(n);
+    float** R=createFloatSquareMatrix(n);
+    initializeMatrix(M, STATIC, n);
+    matTransposeOMPBlockingBased(M, R, n, sublength);
+    TransposedView* V=createTransposedView(M, n, sublength, 3);
+    bool ok=true;
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<n; j++) {
+            ok=ok && viewGet(V, i, j)==R[i][j];
+        }
+    }
+    report("view: viewGet by rows (edge tiles, 3 slots)", ok);
+    //By columns the tiles of a band of columns are used together, so they replace the ones of the rows
+    ok=true;
+    for (int j=n-1; j>=0; j--) {
+        for (int i=n-1; i>=0; i--) {
+            ok=ok && viewGet(V, i, j)==R[i][j];
+        }
+    }
+    //With more tiles than slots some tile has been transposed more than once
+    report("view: viewGet by columns after evictions", ok && (blocks*blocks<=3 || V->materialized>(long)blocks*blocks));
+    ok=true;
+    for (int bj=0; bj<blocks; bj++) {
+        const int length=MIN(sublength, n-bj*sublength);
+        for (int i=0; i<n; i++) {
+            ok=ok && memcmp(viewTileRow(V, i, bj), R[i]+bj*sublength, sizeof(float)*length)==0;
+        }
+    }
+    report("view: viewTileRow bands", ok);
+    viewMaterializeAll(V, T);
+    report("view: viewMaterializeAll", sameMatrix(T, R, n));
+    freeTransposedView(V);
+    freeMemory(R, n);
+    freeMemory(T, n);
+    freeMemory(M, n);
+}
+/*
+ * Name: isNaN16
+ * If the bits of a bfloat16 (bf16 true) or of a half are a NaN
+ */
+static bool isNaN16(uint16_t h, bool bf16) {
+    return bf16 ? ((h&0x7F80)==0x7F80 && (h&0x7F)!=0) : ((h&0x7C00)==0x7C00 && (h&0x3FF)!=0);
+}
+/*
+ * Name: bitsToFloat
+ * Float with the given bits
+ */
+static float bitsToFloat(uint32_t x) {
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+/*
+ * Name: testConversions
+ * floatToBF16 and floatToHalf on known values: ties to even, carry into the exponent up to infinity,
+ * subnormal halves, infinities and NaNs (also signaling, whose payload could become an infinity).
+ * Then every bfloat16 and half that isn't a NaN has to come back the same after the conversion to float
+ * Input: none
+ * Output: none
+ */
+static void testConversions(void) {
+    bool ok=floatToBF16(1.0f)==0x3F80 && floatToBF16(-2.0f)==0xC000 &&
+            floatToBF16(bitsToFloat(0x3F808000))==0x3F80 &&    //tie, even down
+            floatToBF16(bitsToFloat(0x3F818000))==0x3F82 &&    //tie, odd up
+            floatToBF16(bitsToFloat(0x3F808001))==0x3F81 &&    //above the tie
+            floatToBF16(FLT_MAX)==0x7F80 &&                    //carry up to infinity
+            floatToBF16(INFINITY)==0x7F80 && floatToBF16(-INFINITY)==0xFF80 &&
+            isNaN16(floatToBF16(NAN), true) && isNaN16(floatToBF16(bitsToFloat(0x7F800001)), true) &&
+            isNaN16(floatToBF16(bitsToFloat(0xFFC00000)), true);
+    report("bf16: rounding, infinities and NaNs", ok);
+    ok=floatToHalf(1.0f)==0x3C00 && floatToHalf(-0.0f)==0x8000 && floatToHalf(65504.0f)==0x7BFF &&
+       floatToHalf(65519.0f)==0x7BFF && floatToHalf(65520.0f)==0x7C00 &&      //tie with 65536, even up
+       floatToHalf(1.0f+1.0f/2048)==0x3C00 && floatToHalf(1.0f+3.0f/2048)==0x3C02 &&
+       floatToHalf(ldexpf(1.0f, -14))==0x0400 && floatToHalf(ldexpf(1.0f, -24))==0x0001 &&
+       floatToHalf(ldexpf(1.0f, -25))==0x0000 && floatToHalf(ldexpf(3.0f, -26))==0x0001 &&
+       floatToHalf(ldexpf(3.0f, -25))==0x0002 && floatToHalf(ldexpf(1.0f, -30))==0x0000 &&
+       floatToHalf(1e10f)==0x7C00 && floatToHalf(INFINITY)==0x7C00 && floatToHalf(-INFINITY)==0xFC00 &&
+       isNaN16(floatToHalf(NAN), false) && isNaN16(floatToHalf(bitsToFloat(0x7F800001)), false);
+    report("fp16: rounding, subnormals, infinities and NaNs", ok);
+    ok=true;
+    for (uint32_t h=0; h<=0xFFFF; h++) {
+        if(!isNaN16((uint16_t)h, true)) {
+            ok=ok && floatToBF16(bf16ToFloat((uint16_t)h))==h;
+        }
+        else {
+            ok=ok && isnan(bf16ToFloat((uint16_t)h));
+        }
+        if(!isNaN16((uint16_t)h, false)) {
+            ok=ok && floatToHalf(halfToFloat((uint16_t)h))==h;
+        }
+        else {
+            ok=ok && isnan(halfToFloat((uint16_t)h));
+        }
+    }
+    report("bf16, fp16: all the 65536 values come back", ok);
+}
+/*
+ * Name: testOmatcopy
+ * matOmatcopy with and without transposition on a rectangular matrix (partial tiles), for each output
+ * type with scaling only and with accumulation, compared with alpha*op(A)+beta*B computed element by
+ * element (within the rounding of the type, the compiler can fuse the multiply and add). NaN and
+ * infinity in A have to arrive in B. The plain transposition has to be exactly matTranspose
+ * Input: n (int) - Rows of A
+ * Output: none
+ */
+static void testOmatcopy(int n) {
+    const int rows=n, cols=n/2+3, sublength=16;
+    const float alpha=2.5f;
+    float** A=createFloatMatrixContiguous(rows, cols, MINIMUMSUBLENGTH);
+    initializeMatrixRows(A, STATIC, getTestSeed(STATIC), cols, 0, rows);
+    A[0][0]=NAN;
+    A[rows-1][cols-1]=-INFINITY;
+    const char* names[]={"f32", "bf16", "fp16"};
+    const double tolerances[]={1e-6, 1.0/128, 1.0/1024};
+    for (int op=OP_NONE; op<=OP_TRANS; op++) {
+        const int b_rows=(op==OP_TRANS) ? cols : rows;
+        const int b_cols=(op==OP_TRANS) ? rows : cols;
+        for (int type=OUT_F32; type<=OUT_F16; type++) {
+            const size_t element=(type==OUT_F32) ? sizeof(float) : sizeof(uint16_t);
+            char* data=malloc(element*b_rows*b_cols);
+            void** B=malloc(sizeof(void*)*b_rows);
+            float* before=malloc(sizeof(float)*b_rows*b_cols);
+            if(data==NULL || B==NULL || before==NULL) {
+                fprintf(stderr, "ERROR Memory Allocation");
+                exit(1);
+            }
+            for (int i=0; i<b_rows; i++) {
+                B[i]=data+element*i*b_cols;
+            }
+            for (int beta=0; beta<=1; beta++) {
+                //B starts with values exact in all the types, read back as the kernel sees them
+                for (long k=0; k<(long)b_rows*b_cols; k++) {
+                    const float value=(float)(k%7)-3.0f;
+                    before[k]=value;
+                    if(type==OUT_F32) {
+                        ((float*)data)[k]=value;
+                    }
+                    else {
+                        ((uint16_t*)data)[k]=(type==OUT_BF16) ? floatToBF16(value) : floatToHalf(value);
+                    }
+                }
+                const float b=beta ? -0.5f : 0.0f;
+                matOmatcopy(op, rows, cols, alpha, A, b, B, type, sublength);
+                bool ok=true;
+                for (int i=0; i<b_rows; i++) {
+                    for (int j=0; j<b_cols; j++) {
+                        const float a=(op==OP_TRANS) ? A[j][i] : A[i][j];
+                        const float expected=alpha*a+b*before[(long)i*b_cols+j];
+                        float got;
+                        if(type==OUT_F32) {
+                            got=((float*)B[i])[j];
+                        }
+                        else {
+                            const uint16_t h=((uint16_t*)B[i])[j];
+                            got=(type==OUT_BF16) ? bf16ToFloat(h) : halfToFloat(h);
+                        }
+                        if(isnan(expected) || isinf(expected)) {
+                            ok=ok && (isnan(expected) ? isnan(got) : got==expected);
+                        }
+                        else {
+                            ok=ok && fabs(got-expected)<=tolerances[type]*fabs(expected)+1e-6;
+                        }
+                    }
+                }
+                char name[64];
+                snprintf(name, sizeof(name), "omatcopy: %s %s alpha=%.1f beta=%.1f", (op==OP_TRANS) ? "trans" : "none", names[type], alpha, b);
+                report(name, ok);
+            }
+            free(before);
+            free(B);
+            free(data);
+        }
+    }
+    freeMatrixContiguous(A);
+    //Plain transposition of a square matrix: the block kernels, the same result as matTranspose
+    float** M=createFloatSquareMatrix(n);
+    float** T=createFloatSquareMatrix(n);
+    float** R=createFloatSquareMatrix(n);
+    initializeMatrix(M, STATIC, n);
+    matTranspose(M, R, n);
+    matOmatcopy(OP_TRANS, n, n, 1.0f, M, 0.0f, (void**)T, OUT_F32, sublength);
+    report("omatcopy: plain transposition equals matTranspose", sameMatrix(T, R, n));
+    freeMemory(R, n);
+    freeMemory(T, n);
+    freeMemory(M, n);
+}
+/*
+ * Name: permuteNaive
+ * Reference of tensorPermute: for each element of dst its multi-index, and from it the offset in src
+ */
+static void permuteNaive(const float* src, float* dst, int ndim, const long* shape, const int* perm) {
+    long strides[TENSORMAXDIMS];
+    long total=1;
+    for (int k=ndim-1; k>=0; k--) {
+        strides[k]=total;
+        total*=shape[k];
+    }
+    for (long d=0; d<total; d++) {
+        long rest=d, offset=0;
+        for (int k=ndim-1; k>=0; k--) {
+            const long index=rest%shape[perm[k]];
+            rest/=shape[perm[k]];
+            offset+=index*strides[perm[k]];
+        }
+        dst[d]=src[offset];
+    }
+}
+/*
+ * Name: testPermute
+ * tensorPermute compared with permuteNaive: NCHW <-> NHWC (the innermost axis moves, batch of 2D
+ * transpositions), a permutation that keeps W innermost (copies of rows), the reverse of a 3D tensor,
+ * axes of size 1 and the identity. The sizes aren't multiples of the tile, so the partial tiles are used
+ * Input: none
+ * Output: none
+ */
+static void testPermute(void) {
+    const struct {
+        const char* name;
+        int ndim;
+        long shape[TENSORMAXDIMS];
+        int perm[TENSORMAXDIMS];
+    } cases[]={
+        {"NCHW -> NHWC", 4, {3, 37, 9, 21}, {0, 2, 3, 1}},
+        {"NHWC -> NCHW", 4, {3, 9, 21, 37}, {0, 3, 1, 2}},
+        {"NCHW -> CNHW (W stays inner)", 4, {5, 19, 7, 33}, {1, 0, 2, 3}},
+        {"NCHW -> HCNW (W stays inner)", 4, {4, 6, 11, 29}, {2, 1, 0, 3}},
+        {"3D reverse", 3, {17, 45, 23}, {2, 1, 0}},
+        {"axes of size 1", 5, {1, 40, 1, 35, 3}, {3, 1, 4, 0, 2}},
+        {"identity", 3, {13, 7, 19}, {0, 1, 2}},
+    };
+    for (size_t c=0; c<sizeof(cases)/sizeof(cases[0]); c++) {
+        long total=1;
+        for (int k=0; k<cases[c].ndim; k++) {
+            total*=cases[c].shape[k];
+        }
+        float* src=malloc(sizeof(float)*total);
+        float* dst=malloc(sizeof(float)*total);
+        float* ref=malloc(sizeof(float)*total);
+        if(src==NULL || dst==NULL || ref==NULL) {
+            fprintf(stderr, "ERROR Memory Allocation");
+            exit(1);
+        }
+        for (long k=0; k<total; k++) {
+            src[k]=(float)k;
+        }
+        permuteNaive(src, ref, cases[c].ndim, cases[c].shape, cases[c].perm);
+        tensorPermute(src, dst, cases[c].ndim, cases[c].shape, cases[c].perm, 16);
+        char name[64];
+        snprintf(name, sizeof(name), "permute: %s", cases[c].name);
+        report(name, memcmp(dst, ref, sizeof(float)*total)==0);
+        free(ref);
+        free(dst);
+        free(src);
+    }
+}
+/*
+ * Name: testInPlace
+ * matTransposeInPlace compared with a transposition index by index into another buffer: the square
+ * branch (sizes multiple and not of the block, block larger than the matrix), the cycles of the
+ * rectangular one, a single row and a single column and the empty matrices
+ * Input: n (int) - Size of the square matrices
+ * Output: none
+ */
+static void testInPlace(int n) {
+    const struct {
+        int rows;
+        int cols;
+        int sublength;
+    } shapes[]={
+        {1, 1, 16}, {2, 3, 16}, {3, 2, 16}, {7, 13, 16}, {100, 1, 16}, {1, 100, 16}, {0, 5, 16},
+        {1000, 999, 16}, {64, 64, 16}, {n, n, 16}, {n, n, 1}, {5, 5, 64},
+    };
+    for (size_t s=0; s<sizeof(shapes)/sizeof(shapes[0]); s++) {
+        const int rows=shapes[s].rows, cols=shapes[s].cols;
+        const long size=(long)rows*cols;
+        float* A=malloc(sizeof(float)*(size+1));
+        float* R=malloc(sizeof(float)*(size+1));
+        if(A==NULL || R==NULL) {
+            fprintf(stderr, "ERROR Memory Allocation");
+            exit(1);
+        }
+        for (long k=0; k<size; k++) {
+            A[k]=(float)k;
+        }
+        for (int i=0; i<rows; i++) {
+            for (int j=0; j<cols; j++) {
+                R[(long)j*rows+i]=A[(long)i*cols+j];
+            }
+        }
+        const bool done=matTransposeInPlace(A, rows, cols, shapes[s].sublength);
+        char name[64];
+        snprintf(name, sizeof(name), "in place: %d x %d, block %d", rows, cols, shapes[s].sublength);
+        report(name, done && memcmp(A, R, sizeof(float)*size)==0);
+        free(R);
+        free(A);
+    }
+}
+/*
+ * Name: untouched
+ * If all the elements of an n x n matrix still have the value written before the job
+ */
+static bool untouched(float** T, int n, float value) {
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<n; j++) {
+            if(T[i][j]!=value) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+/*
+ * Name: testAsync
+ * Asynchronous API: a big job cancelled while it runs (after its progress has started), a job cancelled
+ * while it's still queued behind it, and jobs that end normally (one symmetric). The final states, the
+ * progress and T are checked: a transposed T equal to matTranspose, T never written by the symmetric
+ * and by the queued cancelled job. At the end asyncDestroy cancels the jobs left in the queue
+ * Input: n (int) - Size of the small matrices
+ * Output: none
+ */
+static void testAsync(int n) {
+    enum {BIG, SMALL, QUEUED, SYMMETRIC, LAST, JOBS};
+    const int big=2048;
+    const float sentinel=-1.0f;
+    int sizes[JOBS];
+    float** M[JOBS];
+    float** T[JOBS];
+    for (int k=0; k<JOBS; k++) {
+        sizes[k]=(k==BIG) ? big : n;
+        M[k]=createFloatSquareMatrix(sizes[k]);
+        T[k]=createFloatSquareMatrix(sizes[k]);
+        initializeMatrix(M[k], (k==SYMMETRIC) ? SYM : STATIC, sizes[k]);
+        for (int i=0; i<sizes[k]; i++) {
+            for (int j=0; j<sizes[k]; j++) {
+                T[k][i][j]=sentinel;
+            }
+        }
+    }
+    AsyncExecutor* executor=asyncCreate(2, NULL);
+    AsyncJob* jobs[JOBS];
+    for (int k=0; k<JOBS; k++) {
+        jobs[k]=asyncSubmit(executor, M[k], T[k], sizes[k], 16);
+    }
+    //The big job is still running, so the third one is surely queued
+    const bool queued=(asyncPoll(jobs[QUEUED])==ASYNC_QUEUED);
+    asyncCancel(jobs[QUEUED]);
+    //Progress of the big job read until it has started, it can only grow
+    bool monotonic=true;
+    double last=0.0, progress=0.0;
+    const struct timespec pause={.tv_sec=0, .tv_nsec=100000};
+    while(asyncPoll(jobs[BIG])<ASYNC_DONE && (asyncPoll(jobs[BIG])!=ASYNC_RUNNING || (progress=asyncProgress(jobs[BIG]))==0.0)) {
+        monotonic=monotonic && asyncProgress(jobs[BIG])>=last;
+        last=asyncProgress(jobs[BIG]);
+        nanosleep(&pause, NULL);
+    }
+    const bool running=(asyncPoll(jobs[BIG])==ASYNC_RUNNING);
+    asyncCancel(jobs[BIG]);
+    report("async: cancel while queued", queued && asyncWait(jobs[QUEUED])==ASYNC_CANCELLED &&
+           asyncProgress(jobs[QUEUED])==0.0 && untouched(T[QUEUED], n, sentinel));
+    report("async: cancel while running", running && monotonic && progress>0.0 && progress<1.0 &&
+           asyncWait(jobs[BIG])==ASYNC_CANCELLED && asyncProgress(jobs[BIG])<1.0);
+    float** R=createFloatSquareMatrix(n);
+    bool ok=true;
+    for (int k=SMALL; k<JOBS; k++) {
+        if(k==QUEUED) {
+            continue;
+        }
+        ok=ok && asyncWait(jobs[k])==ASYNC_DONE && asyncProgress(jobs[k])==1.0;
+        if(k==SYMMETRIC) {
+            ok=ok && asyncSymmetric(jobs[k]) && untouched(T[k], n, sentinel);
+        }
+        else {
+            matTranspose(M[k], R, n);
+            ok=ok && !asyncSymmetric(jobs[k]) && sameMatrix(T[k], R, n);
+        }
+    }
+    report("async: the other jobs done, T transposed or untouched", ok);
+    freeMemory(R, n);
+    for (int k=0; k<JOBS; k++) {
+        asyncRelease(jobs[k]);
+    }
+    //Destroyed with a big job running and one behind it: the second never starts
+    AsyncJob* first=asyncSubmit(executor, M[BIG], T[BIG], big, 16);
+    AsyncJob* second=asyncSubmit(executor, M[SMALL], T[SMALL], n, 16);
+    asyncDestroy(executor);
+    report("async: destroy cancels the queue", asyncWait(second)==ASYNC_CANCELLED && asyncPoll(first)>=ASYNC_DONE);
+    asyncRelease(first);
+    asyncRelease(second);
+    for (int k=0; k<JOBS; k++) {
+        freeMemory(T[k], sizes[k]);
+        freeMemory(M[k], sizes[k]);
+    }
+}
+
+int main(int argc, const char * argv[]) {
+    const int N=(argc>1) ? atoi(argv[1]) : 300;
+    if(N<2) {
+        fprintf(stderr, "Usage: %s [size>=2]\n", argv[0]);
+        exit(1);
+    }
+    testTracked(N);
+    testPacked(N);
+    testView(N);
+    testConversions();
+    testOmatcopy(N);
+    testPermute();
+    testInPlace(N);
+    testAsync(N);
+    printf("\n%d checks failed\n", failures);
+    return failures;
+}
@@ -0,0 +1,16 @@
+# Build of the Python extension mattranspose (mattranspose.c + functions.c)
+# python3 setup.py build_ext --inplace
+from setuptools import setup, Extension
+
+setup(
+    name="mattranspose",
+    version="1.0",
+    ext_modules=[
+        Extension(
+            "mattranspose",
+            sources=["mattranspose.c", "functions.c"],
+            extra_compile_args=["-O2", "-fopenmp"],
+            extra_link_args=["-fopenmp", "-lm", "-pthread"],
+        )
+    ],
+)